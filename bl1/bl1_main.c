@@ -13,6 +13,7 @@
 #include <arch_helpers.h>
 #include <bl1/bl1.h>
 #include <common/bl_common.h>
+#include <common/boot_instr.h>
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/console.h>
@@ -149,6 +150,7 @@ void bl1_main(void)
 
 	bl1_prepare_next_image(image_id);
 
+	boot_instr_print();
 	console_flush();
 }
 
@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <platform_def.h>
@@ -15,10 +16,64 @@
 #include <common/debug.h>
 #include <common/desc_image_load.h>
 #include <drivers/auth/auth_mod.h>
+#if PARALLEL_IMAGE_AUTH
+#include <drivers/auth/auth_offload.h>
+#endif
 #include <plat/common/platform.h>
 
 #include "bl2_private.h"
 
+#if PARALLEL_IMAGE_AUTH
+/* Image whose post-load handling waits for the next image to be loaded */
+static unsigned int deferred_image_id = INVALID_IMAGE_ID;
+#endif
+
+static void bl2_post_image_load(unsigned int image_id)
+{
+	int err;
+
+#if PARALLEL_IMAGE_AUTH
+	if (auth_offload_is_pending(image_id)) {
+		err = auth_offload_wait(image_id);
+		if (err != 0) {
+			ERROR("BL2: Failed to authenticate image id %d (%i)\n",
+			      image_id, err);
+			plat_error_handler(err);
+		}
+	}
+#endif
+
+	/* Allow platform to handle image information. */
+	err = bl2_plat_handle_post_image_load(image_id);
+	if (err != 0) {
+		ERROR("BL2: Failure in post image load handling (%i)\n", err);
+		plat_error_handler(err);
+	}
+}
+
+/*
+ * Hand the image deferred by the previous iteration over to the platform, and
+ * defer the current one if another core is still checking its hash. Images
+ * are thus always handled in load order.
+ */
+static bool bl2_defer_post_image_load(unsigned int image_id)
+{
+#if PARALLEL_IMAGE_AUTH
+	if (deferred_image_id != INVALID_IMAGE_ID) {
+		bl2_post_image_load(deferred_image_id);
+		deferred_image_id = INVALID_IMAGE_ID;
+	}
+
+	if ((image_id != INVALID_IMAGE_ID) &&
+	    auth_offload_is_pending(image_id)) {
+		deferred_image_id = image_id;
+		return true;
+	}
+#endif
+
+	return false;
+}
+
 /*******************************************************************************
  * This function loads SCP_BL2/BL3x images and returns the ep_info for
  * the next executable image.
@@ -41,6 +96,10 @@ struct entry_point_info *bl2_load_images(void)
 	assert(bl2_load_info->h.version >= VERSION_2);
 	bl2_node_info = bl2_load_info->head;
 
+#if PARALLEL_IMAGE_AUTH
+	(void)auth_offload_init();
+#endif
+
 	while (bl2_node_info != NULL) {
 		/*
 		 * Perform platform setup before loading the image,
@@ -78,17 +137,20 @@ struct entry_point_info *bl2_load_images(void)
 			INFO("BL2: Skip loading image id %d\n", bl2_node_info->image_id);
 		}
 
-		/* Allow platform to handle image information. */
-		err = bl2_plat_handle_post_image_load(bl2_node_info->image_id);
-		if (err != 0) {
-			ERROR("BL2: Failure in post image load handling (%i)\n", err);
-			plat_error_handler(err);
+		if (!bl2_defer_post_image_load(bl2_node_info->image_id)) {
+			bl2_post_image_load(bl2_node_info->image_id);
 		}
 
 		/* Go to next image */
 		bl2_node_info = bl2_node_info->next_load_info;
 	}
 
+	(void)bl2_defer_post_image_load(INVALID_IMAGE_ID);
+
+#if PARALLEL_IMAGE_AUTH
+	auth_offload_exit();
+#endif
+
 	/*
 	 * Get information to pass to the next image.
 	 */
@@ -13,6 +13,7 @@
 #include <bl31/bl31.h>
 #include <bl31/ehf.h>
 #include <common/bl_common.h>
+#include <common/boot_instr.h>
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <drivers/console.h>
@@ -155,6 +156,7 @@ void bl31_main(void)
 	 */
 	bl31_prepare_next_image_entry();
 
+	boot_instr_print();
 	console_flush();
 
 	/*
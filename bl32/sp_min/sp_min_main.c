@@ -14,6 +14,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/bl_common.h>
+#include <common/boot_instr.h>
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <context.h>
@@ -190,6 +191,8 @@ void sp_min_main(void)
 	 */
 	sp_min_prepare_next_image_entry();
 
+	boot_instr_print();
+
 	/*
 	 * Perform any platform specific runtime setup prior to cold boot exit
 	 * from SP_MIN.
@@ -6,19 +6,34 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <arch.h>
 #include <arch_features.h>
 #include <arch_helpers.h>
 #include <common/bl_common.h>
+#include <common/boot_instr.h>
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
+#if PARALLEL_IMAGE_AUTH && defined(IMAGE_BL2)
+#include <drivers/auth/auth_offload.h>
+#endif
 #include <drivers/io/io_storage.h>
 #include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
 #include <plat/common/platform.h>
 
+#if INCREMENTAL_AUTH_HASH
+/*
+ * Images hashed on load are read in chunks of this size, so that each chunk is
+ * still hot in the data cache when it is fed to the hash calculation.
+ */
+# ifndef PLAT_AUTH_HASH_CHUNK_SIZE
+#  define PLAT_AUTH_HASH_CHUNK_SIZE	U(0x8000)
+# endif
+#endif /* INCREMENTAL_AUTH_HASH */
+
 #if TRUSTED_BOARD_BOOT
 # ifdef DYN_DISABLE_AUTH
 static int disable_auth;
@@ -59,15 +74,59 @@ uintptr_t page_align(uintptr_t value, unsigned dir)
 	return value;
 }
 
+#if INCREMENTAL_AUTH_HASH
+/*
+ * Read an image chunk by chunk and pass every chunk to the authentication
+ * module, so that the image does not have to be read again from memory to be
+ * hashed.
+ */
+static int read_and_hash_image(uintptr_t image_handle, uintptr_t image_base,
+			       size_t image_size, size_t *bytes_read)
+{
+	size_t chunk, chunk_read;
+	int io_result;
+
+	*bytes_read = 0U;
+
+	while (*bytes_read < image_size) {
+		chunk = MIN(image_size - *bytes_read,
+			    (size_t)PLAT_AUTH_HASH_CHUNK_SIZE);
+
+		io_result = io_read(image_handle, image_base + *bytes_read,
+				    chunk, &chunk_read);
+		if (io_result != 0) {
+			return io_result;
+		}
+
+		if (chunk_read == 0U) {
+			break;
+		}
+
+		if (auth_mod_hash_update((void *)(image_base + *bytes_read),
+					 (unsigned int)chunk_read) != 0) {
+			return -EAUTH;
+		}
+
+		*bytes_read += chunk_read;
+	}
+
+	return 0;
+}
+#endif /* INCREMENTAL_AUTH_HASH */
+
 /*******************************************************************************
  * Internal function to load an image at a specific address given
  * an image ID and extents of free memory.
  *
+ * If 'hash_on_load' is set, the authentication module gets to hash the image
+ * as it is read (INCREMENTAL_AUTH_HASH only).
+ *
  * If the load is successful then the image information is updated.
  *
  * Returns 0 on success, a negative error code otherwise.
  ******************************************************************************/
-static int load_image(unsigned int image_id, image_info_t *image_data)
+static int load_image(unsigned int image_id, image_info_t *image_data,
+		      bool hash_on_load)
 {
 	uintptr_t dev_handle;
 	uintptr_t image_handle;
@@ -123,7 +182,16 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+#if INCREMENTAL_AUTH_HASH
+	if (hash_on_load) {
+		io_result = read_and_hash_image(image_handle, image_base,
+						image_size, &bytes_read);
+	} else
+#endif
+	{
+		io_result = io_read(image_handle, image_base, image_size,
+				    &bytes_read);
+	}
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
@@ -150,9 +218,11 @@ exit:
 static int load_image_flush(unsigned int image_id,
 			    image_info_t *image_data)
 {
+	uint64_t start = boot_instr_start();
 	int rc;
 
-	rc = load_image(image_id, image_data);
+	rc = load_image(image_id, image_data, false);
+	boot_instr_end("load", image_id, start);
 	if (rc == 0) {
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
@@ -173,6 +243,8 @@ static int load_auth_image_recursive(unsigned int image_id,
 {
 	int rc;
 	unsigned int parent_id;
+	bool hash_on_load = false;
+	uint64_t start;
 
 	/* Use recursion to authenticate parent images */
 	rc = auth_mod_get_parent_id(image_id, &parent_id);
@@ -183,16 +255,39 @@ static int load_auth_image_recursive(unsigned int image_id,
 		}
 	}
 
+#if INCREMENTAL_AUTH_HASH
+	/* The parents are authenticated, so the expected hash is known */
+	hash_on_load = (auth_mod_hash_start(image_id) == 0);
+#endif
+
 	/* Load the image */
-	rc = load_image(image_id, image_data);
+	start = boot_instr_start();
+	rc = load_image(image_id, image_data, hash_on_load);
+	boot_instr_end("load", image_id, start);
 	if (rc != 0) {
 		return rc;
 	}
 
+#if PARALLEL_IMAGE_AUTH && defined(IMAGE_BL2)
+	/*
+	 * Let another core check the hash while the next image is loaded. The
+	 * result is collected by the loader before the image is used.
+	 */
+	if ((is_parent_image == 0) &&
+	    ((image_data->h.attr & IMAGE_ATTRIB_ASYNC_AUTH) != 0U) &&
+	    (auth_offload_submit(image_id, image_data) == 0)) {
+		flush_dcache_range(image_data->image_base,
+				   image_data->image_size);
+		return 0;
+	}
+#endif
+
 	/* Authenticate it */
+	start = boot_instr_start();
 	rc = auth_mod_verify_img(image_id,
 				 (void *)image_data->image_base,
 				 image_data->image_size);
+	boot_instr_end("auth", image_id, start);
 	if (rc != 0) {
 		/* Authentication error, zero memory and flush it right away. */
 		zero_normalmem((void *)image_data->image_base,
@@ -237,12 +332,15 @@ static int load_auth_image_internal(unsigned int image_id,
  ******************************************************************************/
 int load_auth_image(unsigned int image_id, image_info_t *image_data)
 {
+	uint64_t start = boot_instr_start();
 	int err;
 
 	do {
 		err = load_auth_image_internal(image_id, image_data);
 	} while ((err != 0) && (plat_try_next_boot_source() != 0));
 
+	boot_instr_end("image", image_id, start);
+
 	return err;
 }
 
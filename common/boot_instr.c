@@ -0,0 +1,146 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <common/boot_instr.h>
+#include <lib/spinlock.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+#if defined(IMAGE_BL1)
+#define BOOT_INSTR_IMAGE	"bl1"
+#elif defined(IMAGE_BL2)
+#define BOOT_INSTR_IMAGE	"bl2"
+#elif defined(IMAGE_BL31)
+#define BOOT_INSTR_IMAGE	"bl31"
+#elif defined(IMAGE_BL32)
+#define BOOT_INSTR_IMAGE	"bl32"
+#else
+#define BOOT_INSTR_IMAGE	"unknown"
+#endif
+
+#ifndef BOOT_INSTR_MAX_SAMPLES
+#define BOOT_INSTR_MAX_SAMPLES	32U
+#endif
+
+struct boot_instr_sample {
+	const char *event;
+	unsigned int id;
+	uint64_t ticks;
+};
+
+/*
+ * Sample of a core taken with its data cache disabled, e.g. the translation
+ * tables setup or the way down of CPU_OFF. It is written straight to memory
+ * by the core itself, and never written by the readers, which invalidate it
+ * before reading it. 'seq' is incremented once the sample is written.
+ */
+struct boot_instr_core {
+	struct boot_instr_sample sample;
+	volatile unsigned int seq;
+} __aligned(CACHE_WRITEBACK_GRANULE);
+
+static spinlock_t boot_instr_lock;
+static bool freq_printed;
+static struct boot_instr_sample samples[BOOT_INSTR_MAX_SAMPLES];
+static unsigned int n_samples;
+static unsigned int n_dropped;
+static struct boot_instr_core core_samples[PLATFORM_CORE_COUNT];
+static unsigned int core_printed[PLATFORM_CORE_COUNT];
+
+/*
+ * The samples are only stored here, so that the measured paths, including the
+ * nested ones, do not include any console output. boot_instr_print() prints
+ * them.
+ */
+void boot_instr_end(const char *event, unsigned int id, uint64_t start)
+{
+	struct boot_instr_core *core;
+	uint64_t ticks;
+
+	isb();
+	ticks = read_cntpct_el0() - start;
+
+	/* The lock and the shared samples cannot be used without the cache */
+	if (!is_dcache_enabled()) {
+		core = &core_samples[plat_my_core_pos()];
+		core->sample.event = event;
+		core->sample.id = id;
+		core->sample.ticks = ticks;
+		dmbst();
+		core->seq++;
+		return;
+	}
+
+	spin_lock(&boot_instr_lock);
+
+	if (n_samples < BOOT_INSTR_MAX_SAMPLES) {
+		samples[n_samples].event = event;
+		samples[n_samples].id = id;
+		samples[n_samples].ticks = ticks;
+		n_samples++;
+	} else {
+		n_dropped++;
+	}
+
+	spin_unlock(&boot_instr_lock);
+}
+
+static void print_sample(const struct boot_instr_sample *s)
+{
+	(void)printf("BOOT_INSTR,%s,%s,%u,%llu\n", BOOT_INSTR_IMAGE, s->event,
+		     s->id, (unsigned long long)s->ticks);
+}
+
+/*
+ * Print the samples taken since the previous call, along with the counter
+ * frequency the first time. Called with the data cache enabled, at the end of
+ * each image and after the measured PSCI calls.
+ */
+void boot_instr_print(void)
+{
+	unsigned int i, seq;
+
+	spin_lock(&boot_instr_lock);
+
+	if (!freq_printed) {
+		(void)printf("BOOT_INSTR,%s,freq,0,%u\n", BOOT_INSTR_IMAGE,
+			     (unsigned int)read_cntfrq_el0());
+		freq_printed = true;
+	}
+
+	inv_dcache_range((uintptr_t)core_samples, sizeof(core_samples));
+
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		seq = core_samples[i].seq;
+		if (seq == core_printed[i]) {
+			continue;
+		}
+
+		dmbld();
+		print_sample(&core_samples[i].sample);
+		core_printed[i] = seq;
+	}
+
+	for (i = 0U; i < n_samples; i++) {
+		print_sample(&samples[i]);
+	}
+
+	if (n_dropped != 0U) {
+		(void)printf("BOOT_INSTR,%s,dropped,0,%u\n", BOOT_INSTR_IMAGE,
+			     n_dropped);
+	}
+
+	n_samples = 0U;
+	n_dropped = 0U;
+
+	spin_unlock(&boot_instr_lock);
+}
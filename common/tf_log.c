@@ -1,19 +1,259 @@
 /*
  * Copyright (c) 2017-2019, Arm Limited and Contributors. All rights reserved.
+ * Copyright 2023 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <stdarg.h>
 #include <assert.h>
+#include <errno.h>
 #include <stdio.h>
+#include <string.h>
 
+#include <arch_helpers.h>
 #include <common/debug.h>
+#include <lib/spinlock.h>
 #include <plat/common/platform.h>
+#include <platform_def.h>
 
 /* Set the default maximum log level to the `LOG_LEVEL` build flag */
 static unsigned int max_log_level = LOG_LEVEL;
 
+#if ENABLE_LOG_BUFFER
+/*
+ * Log buffer: the log is also appended, as records, to a memory region given
+ * by the platform, e.g. for the normal world to read it. The region is kept
+ * as is by the next images, and the next boots, as long as its header is
+ * valid; the oldest records are dropped to make room for new ones.
+ *
+ * The characters printed are captured by a console, in a line per core. A line
+ * is appended as a record once complete, or at the end of tf_log(). Records
+ * are only appended while the data cache is enabled, as they are serialized
+ * by a spinlock.
+ *
+ * Layout of the region, for its readers:
+ *   - struct log_buffer, then 'size' bytes of data,
+ *   - 'head' and 'tail' only grow, the records are at their value modulo
+ *     'size', from 'tail' up to 'head' and may wrap around,
+ *   - each record is a struct log_record followed by 'len' characters,
+ *     padded to LOG_BUFFER_ALIGN bytes.
+ */
+#define LOG_BUFFER_MAGIC	U(0x424c4654)	/* "TFLB" */
+#define LOG_BUFFER_VERSION	U(1)
+#define LOG_BUFFER_ALIGN	U(8)
+#define LOG_BUFFER_LINE_MAX	U(160)
+
+#ifdef IMAGE_BL31
+#define LOG_BUFFER_LINES	PLATFORM_CORE_COUNT
+#else
+#define LOG_BUFFER_LINES	U(1)
+#endif
+
+struct log_buffer {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t size;
+	/* Incremented at each boot */
+	uint32_t boot;
+	/* Sequence number of the next record */
+	uint64_t seq;
+	uint64_t head;
+	uint64_t tail;
+	uint8_t data[];
+};
+
+struct log_record {
+	uint64_t seq;
+	/* System counter */
+	uint64_t time;
+	uint32_t boot;
+	uint16_t len;
+	uint8_t level;
+	uint8_t line;
+};
+
+/*
+ * The region may be rewritten by its readers, e.g. the normal world at
+ * runtime: its header is only validated by tf_log_buffer_init(), then the
+ * state below is used and published to the header.
+ */
+static struct log_buffer *log_buf;
+static size_t log_buf_size;
+static uint32_t log_buf_boot;
+static uint64_t log_buf_seq;
+static uint64_t log_buf_head;
+static uint64_t log_buf_tail;
+static spinlock_t log_buf_lock;
+
+static struct {
+	unsigned int level;
+	size_t len;
+	char text[LOG_BUFFER_LINE_MAX];
+} log_lines[LOG_BUFFER_LINES];
+
+static unsigned int log_line_idx(void)
+{
+#ifdef IMAGE_BL31
+	return plat_my_core_pos();
+#else
+	return 0U;
+#endif
+}
+
+static size_t log_record_size(size_t len)
+{
+	return round_up(sizeof(struct log_record) + len, LOG_BUFFER_ALIGN);
+}
+
+static void log_buffer_write(uint64_t offset, const void *src, size_t len)
+{
+	size_t pos = (size_t)(offset % log_buf_size);
+	size_t n = MIN(len, log_buf_size - pos);
+
+	(void)memcpy(&log_buf->data[pos], src, n);
+	(void)memcpy(&log_buf->data[0], (const uint8_t *)src + n, len - n);
+}
+
+static void log_buffer_read(uint64_t offset, void *dst, size_t len)
+{
+	size_t pos = (size_t)(offset % log_buf_size);
+	size_t n = MIN(len, log_buf_size - pos);
+
+	(void)memcpy(dst, &log_buf->data[pos], n);
+	(void)memcpy((uint8_t *)dst + n, &log_buf->data[0], len - n);
+}
+
+/* Writes the state of the buffer to its header, for the readers */
+static void log_buffer_publish(void)
+{
+	log_buf->magic = LOG_BUFFER_MAGIC;
+	log_buf->version = LOG_BUFFER_VERSION;
+	log_buf->size = (uint32_t)log_buf_size;
+	log_buf->boot = log_buf_boot;
+	log_buf->seq = log_buf_seq;
+	log_buf->head = log_buf_head;
+	log_buf->tail = log_buf_tail;
+}
+
+static void log_buffer_append(unsigned int idx)
+{
+	size_t len = log_lines[idx].len;
+	size_t size = log_record_size(len);
+	struct log_record rec;
+
+	if (!is_dcache_enabled())
+		return;
+
+	spin_lock(&log_buf_lock);
+
+	/*
+	 * Drop the oldest records. Their length is read back from the region,
+	 * it only moves the tail, which is kept within the data.
+	 */
+	while ((log_buf_head + size - log_buf_tail) > log_buf_size) {
+		log_buffer_read(log_buf_tail, &rec, sizeof(rec));
+		log_buf_tail += log_record_size(rec.len);
+		if (log_buf_tail > log_buf_head)
+			log_buf_tail = log_buf_head;
+	}
+
+	rec.seq = log_buf_seq;
+	rec.time = read_cntpct_el0();
+	rec.boot = log_buf_boot;
+	rec.len = (uint16_t)len;
+	rec.level = (uint8_t)log_lines[idx].level;
+	rec.line = (uint8_t)idx;
+
+	log_buffer_write(log_buf_head, &rec, sizeof(rec));
+	log_buffer_write(log_buf_head + sizeof(rec), log_lines[idx].text, len);
+
+	log_buf_seq++;
+	log_buf_head += size;
+	log_buffer_publish();
+
+	spin_unlock(&log_buf_lock);
+}
+
+static void log_line_end(unsigned int idx)
+{
+	if (log_lines[idx].len == 0U)
+		return;
+
+	log_buffer_append(idx);
+	log_lines[idx].len = 0U;
+}
+
+static int log_buffer_putc(int character, console_t *console)
+{
+	unsigned int idx = log_line_idx();
+
+	log_lines[idx].text[log_lines[idx].len] = (char)character;
+	log_lines[idx].len++;
+
+	if ((character == '\n') || (log_lines[idx].len == LOG_BUFFER_LINE_MAX))
+		log_line_end(idx);
+
+	return character;
+}
+
+static void log_buffer_flush(console_t *console)
+{
+	flush_dcache_range((uintptr_t)log_buf,
+			   sizeof(*log_buf) + log_buf_size);
+}
+
+static console_t log_buffer_console = {
+	.flags = CONSOLE_FLAG_BOOT | CONSOLE_FLAG_RUNTIME,
+	.putc = log_buffer_putc,
+	.flush = log_buffer_flush,
+};
+
+/*
+ * Starts appending the log to the region at 'base', continuing the records it
+ * holds if any. 'new_boot' is set by the first image of a boot.
+ */
+int tf_log_buffer_init(uintptr_t base, size_t size, bool new_boot)
+{
+	struct log_buffer *buf = (struct log_buffer *)base;
+	size_t data_size;
+
+	if ((base % LOG_BUFFER_ALIGN) != 0U ||
+	    size < (sizeof(*buf) + log_record_size(LOG_BUFFER_LINE_MAX)))
+		return -EINVAL;
+
+	data_size = round_down(size - sizeof(*buf), LOG_BUFFER_ALIGN);
+
+	if ((buf->magic != LOG_BUFFER_MAGIC) ||
+	    (buf->version != LOG_BUFFER_VERSION) ||
+	    (buf->size != data_size) ||
+	    (buf->tail > buf->head) ||
+	    ((buf->head - buf->tail) > data_size) ||
+	    ((buf->head % LOG_BUFFER_ALIGN) != 0U) ||
+	    ((buf->tail % LOG_BUFFER_ALIGN) != 0U)) {
+		log_buf_boot = 0U;
+		log_buf_seq = 0U;
+		log_buf_head = 0U;
+		log_buf_tail = 0U;
+	} else {
+		log_buf_boot = buf->boot;
+		log_buf_seq = buf->seq;
+		log_buf_head = buf->head;
+		log_buf_tail = buf->tail;
+	}
+
+	if (new_boot)
+		log_buf_boot++;
+
+	log_buf_size = data_size;
+	log_buf = buf;
+	log_buffer_publish();
+	(void)console_register(&log_buffer_console);
+
+	return 0;
+}
+#endif /* ENABLE_LOG_BUFFER */
+
 /*
  * The common log function which is invoked by TF-A code.
  * This function should not be directly invoked and is meant to be
@@ -37,6 +277,10 @@ void tf_log(const char *fmt, ...)
 	if (log_level > max_log_level)
 		return;
 
+#if ENABLE_LOG_BUFFER
+	log_lines[log_line_idx()].level = log_level;
+#endif
+
 	prefix_str = plat_log_get_prefix(log_level);
 
 	while (*prefix_str != '\0') {
@@ -47,6 +291,11 @@ void tf_log(const char *fmt, ...)
 	va_start(args, fmt);
 	(void)vprintf(fmt + 1, args);
 	va_end(args);
+
+#if ENABLE_LOG_BUFFER
+	log_line_end(log_line_idx());
+	log_lines[log_line_idx()].level = LOG_LEVEL_NONE;
+#endif
 }
 
 /*
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <string.h>
+
+/* mbed TLS headers */
+#include <mbedtls/md.h>
+
+#include <common/debug.h>
+#include <drivers/auth/auth_cert_cache.h>
+
+/*
+ * Certificates authenticated by this boot stage, e.g. the trusted key
+ * certificate, which is the parent of every key certificate.
+ *
+ * A certificate found here with the same image ID and digest is byte for byte
+ * the one which has already been checked, so its signature and NV counter do
+ * not have to be verified again. The parameters it carries for the child
+ * images are still extracted by the image parser.
+ */
+static auth_cert_cache_t cert_cache;
+
+int auth_cert_cache_hash(const void *img_ptr, unsigned int img_len,
+			 uint8_t *hash)
+{
+	const mbedtls_md_info_t *md_info;
+
+	md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+	if (md_info == NULL) {
+		return -1;
+	}
+
+	assert(mbedtls_md_get_size(md_info) == AUTH_CERT_CACHE_HASH_SIZE);
+
+	return mbedtls_md(md_info, img_ptr, img_len, hash);
+}
+
+bool auth_cert_cache_lookup(unsigned int img_id, const uint8_t *hash)
+{
+	const auth_cert_cache_entry_t *entry;
+	unsigned int i;
+
+	for (i = 0U; i < cert_cache.num_entries; i++) {
+		entry = &cert_cache.entries[i];
+
+		if ((entry->img_id == img_id) &&
+		    (memcmp(entry->hash, hash, sizeof(entry->hash)) == 0)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void auth_cert_cache_add(unsigned int img_id, const uint8_t *hash)
+{
+	auth_cert_cache_entry_t *entry;
+
+	if (auth_cert_cache_lookup(img_id, hash)) {
+		return;
+	}
+
+	if (cert_cache.num_entries >= AUTH_CERT_CACHE_ENTRIES) {
+		VERBOSE("Certificate cache full, not caching image id=%u\n",
+			img_id);
+		return;
+	}
+
+	entry = &cert_cache.entries[cert_cache.num_entries++];
+	entry->img_id = img_id;
+	(void)memcpy(entry->hash, hash, sizeof(entry->hash));
+}
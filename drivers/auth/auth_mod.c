@@ -10,8 +10,12 @@
 
 #include <platform_def.h>
 
+#include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/tbbr/cot_def.h>
+#if AUTH_CERT_CACHE
+#include <drivers/auth/auth_cert_cache.h>
+#endif
 #include <drivers/auth/auth_common.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/auth/crypto_mod.h>
@@ -31,6 +35,11 @@
 
 #pragma weak plat_set_nv_ctr2
 
+#if INCREMENTAL_AUTH_HASH
+/* Image whose hash is being calculated while it is loaded */
+static unsigned int hash_img_id = INVALID_IMAGE_ID;
+static unsigned int hash_img_len;
+#endif
 
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
@@ -99,6 +108,18 @@ static int auth_hash(const auth_method_param_hash_t *param,
 	unsigned int data_len, hash_der_len;
 	int rc = 0;
 
+#if INCREMENTAL_AUTH_HASH
+	/* The hash was calculated while the image was being loaded */
+	if (hash_img_id == img_desc->img_id) {
+		hash_img_id = INVALID_IMAGE_ID;
+		if (hash_img_len != img_len) {
+			return 1;
+		}
+
+		return crypto_mod_hash_verify();
+	}
+#endif
+
 	/* Get the hash from the parent image. This hash will be DER encoded
 	 * and contain the hash algorithm */
 	rc = auth_get_param(param->hash, img_desc->parent,
@@ -326,6 +347,172 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
 	return 0;
 }
 
+#if INCREMENTAL_AUTH_HASH
+/*
+ * Prepare to hash an image while it is being loaded
+ *
+ * Only raw images authenticated by a hash over their whole content qualify;
+ * certificates still go through the image parser once they are in memory.
+ * The parent image must have been authenticated already, so the expected hash
+ * is known before the first chunk is read.
+ *
+ * Return value:
+ *   0 = the loader must pass every chunk to auth_mod_hash_update(),
+ *   1 = the image will be hashed by auth_mod_verify_img() as usual
+ */
+int auth_mod_hash_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc = NULL;
+	const auth_method_desc_t *auth_method;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int i;
+
+	hash_img_id = INVALID_IMAGE_ID;
+
+	img_desc = FCONF_GET_PROPERTY(tbbr, cot, img_id);
+	if ((img_desc->img_type != IMG_RAW) ||
+	    (img_desc->img_auth_methods == NULL) ||
+	    (img_desc->parent == NULL)) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if ((auth_method->type == AUTH_METHOD_HASH) &&
+		    (auth_method->param.hash.data->type == AUTH_PARAM_RAW_DATA)) {
+			break;
+		}
+	}
+
+	if (i == AUTH_METHOD_NUM) {
+		return 1;
+	}
+
+	if (auth_get_param(auth_method->param.hash.hash, img_desc->parent,
+			   &hash_der_ptr, &hash_der_len) != 0) {
+		return 1;
+	}
+
+	if (crypto_mod_hash_start(hash_der_ptr, hash_der_len) != 0) {
+		return 1;
+	}
+
+	hash_img_id = img_id;
+	hash_img_len = 0;
+
+	return 0;
+}
+
+/*
+ * Add a freshly loaded chunk of the image to the hash calculation
+ */
+int auth_mod_hash_update(const void *ptr, unsigned int len)
+{
+	int rc;
+
+	assert(hash_img_id != INVALID_IMAGE_ID);
+
+	rc = crypto_mod_hash_update(ptr, len);
+	if (rc != 0) {
+		hash_img_id = INVALID_IMAGE_ID;
+		return rc;
+	}
+
+	hash_img_len += len;
+
+	return 0;
+}
+#endif /* INCREMENTAL_AUTH_HASH */
+
+#if PARALLEL_IMAGE_AUTH
+/*
+ * Get the hash that authenticates an image on behalf of its parent
+ *
+ * Only raw images authenticated exclusively by a hash over their whole
+ * content qualify: such an image needs no PK operation, NV counter or parser
+ * state, so it can be verified on another core while the boot goes on. The
+ * parent image must have been authenticated already.
+ *
+ * Return value:
+ *   0 = the DER encoded hash is returned in 'hash_der_ptr'/'hash_der_len',
+ *   1 = the image must be verified by auth_mod_verify_img()
+ */
+int auth_mod_get_img_hash(unsigned int img_id, void **hash_der_ptr,
+			  unsigned int *hash_der_len)
+{
+	const auth_img_desc_t *img_desc = NULL;
+	const auth_method_desc_t *auth_method;
+	const auth_method_param_hash_t *hash_param = NULL;
+	int i;
+
+	img_desc = FCONF_GET_PROPERTY(tbbr, cot, img_id);
+	if ((img_desc->img_type != IMG_RAW) ||
+	    (img_desc->img_auth_methods == NULL) ||
+	    (img_desc->parent == NULL)) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if (auth_method->type == AUTH_METHOD_NONE) {
+			continue;
+		}
+
+		if ((auth_method->type != AUTH_METHOD_HASH) ||
+		    (auth_method->param.hash.data->type != AUTH_PARAM_RAW_DATA) ||
+		    (hash_param != NULL)) {
+			return 1;
+		}
+		hash_param = &auth_method->param.hash;
+	}
+
+	if (hash_param == NULL) {
+		return 1;
+	}
+
+	if (auth_get_param(hash_param->hash, img_desc->parent,
+			   hash_der_ptr, hash_der_len) != 0) {
+		return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Verify an image against a hash obtained from auth_mod_get_img_hash()
+ *
+ * The caller keeps its own copy of the hash, so this function does not touch
+ * the parameters extracted from the parent image and may run concurrently
+ * with the authentication of other images.
+ *
+ * Return: 0 = success, Otherwise = error
+ */
+int auth_mod_verify_img_hash(unsigned int img_id,
+			     void *img_ptr,
+			     unsigned int img_len,
+			     void *hash_der_ptr,
+			     unsigned int hash_der_len)
+{
+	const auth_img_desc_t *img_desc = NULL;
+	int rc;
+
+	img_desc = FCONF_GET_PROPERTY(tbbr, cot, img_id);
+
+	rc = img_parser_check_integrity(img_desc->img_type, img_ptr, img_len);
+	return_if_error(rc);
+
+	rc = crypto_mod_verify_hash(img_ptr, img_len,
+				    hash_der_ptr, hash_der_len);
+	return_if_error(rc);
+
+	/* Mark image as authenticated */
+	auth_img_flags[img_desc->img_id] |= IMG_FLAG_AUTHENTICATED;
+
+	return 0;
+}
+#endif /* PARALLEL_IMAGE_AUTH */
+
 /*
  * Initialize the different modules in the authentication framework
  */
@@ -359,6 +546,10 @@ int auth_mod_verify_img(unsigned int img_id,
 	bool need_nv_ctr_upgrade = false;
 	bool sig_auth_done = false;
 	const auth_method_param_nv_ctr_t *nv_ctr_param = NULL;
+#if AUTH_CERT_CACHE
+	uint8_t cert_hash[AUTH_CERT_CACHE_HASH_SIZE];
+	bool cert_cached = false;
+#endif
 
 	/* Get the image descriptor from the chain of trust */
 	img_desc = FCONF_GET_PROPERTY(tbbr, cot, img_id);
@@ -367,6 +558,15 @@ int auth_mod_verify_img(unsigned int img_id,
 	rc = img_parser_check_integrity(img_desc->img_type, img_ptr, img_len);
 	return_if_error(rc);
 
+#if AUTH_CERT_CACHE
+	/* Certificates verified earlier in the boot need no PK operation */
+	if (img_desc->img_type == IMG_CERT) {
+		rc = auth_cert_cache_hash(img_ptr, img_len, cert_hash);
+		return_if_error(rc);
+		cert_cached = auth_cert_cache_lookup(img_id, cert_hash);
+	}
+#endif
+
 	/* Authenticate the image using the methods indicated in the image
 	 * descriptor. */
 	if (img_desc->img_auth_methods == NULL)
@@ -382,11 +582,24 @@ int auth_mod_verify_img(unsigned int img_id,
 					img_desc, img_ptr, img_len);
 			break;
 		case AUTH_METHOD_SIG:
+#if AUTH_CERT_CACHE
+			if (cert_cached) {
+				rc = 0;
+				break;
+			}
+#endif
 			rc = auth_signature(&auth_method->param.sig,
 					img_desc, img_ptr, img_len);
 			sig_auth_done = true;
 			break;
 		case AUTH_METHOD_NV_CTR:
+#if AUTH_CERT_CACHE
+			/* The NV counter was checked and upgraded already */
+			if (cert_cached) {
+				rc = 0;
+				break;
+			}
+#endif
 			nv_ctr_param = &auth_method->param.nv_ctr;
 			rc = auth_nvctr(nv_ctr_param,
 					img_desc, img_ptr, img_len,
@@ -435,6 +648,12 @@ int auth_mod_verify_img(unsigned int img_id,
 		}
 	}
 
+#if AUTH_CERT_CACHE
+	if ((img_desc->img_type == IMG_CERT) && !cert_cached) {
+		auth_cert_cache_add(img_id, cert_hash);
+	}
+#endif
+
 	/* Mark image as authenticated */
 	auth_img_flags[img_desc->img_id] |= IMG_FLAG_AUTHENTICATED;
 
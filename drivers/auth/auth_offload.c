@@ -0,0 +1,269 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/auth/auth_mod.h>
+#include <drivers/auth/auth_offload.h>
+#include <lib/spinlock.h>
+#include <lib/utils.h>
+#include <plat/common/platform.h>
+
+/* Must be a power of two */
+#ifndef PLAT_AUTH_OFFLOAD_JOBS
+#define PLAT_AUTH_OFFLOAD_JOBS		U(4)
+#endif
+
+/* Large enough for the DigestInfo of a SHA-512 hash */
+#define AUTH_OFFLOAD_HASH_DER_SIZE	U(96)
+
+#define JOB_IDX(n)	((n) & (PLAT_AUTH_OFFLOAD_JOBS - 1U))
+
+CASSERT((PLAT_AUTH_OFFLOAD_JOBS & (PLAT_AUTH_OFFLOAD_JOBS - 1U)) == 0U,
+	assert_auth_offload_jobs_power_of_two);
+
+typedef struct auth_offload_job {
+	unsigned int img_id;
+	uintptr_t img_base;
+	unsigned int img_len;
+	unsigned int hash_der_len;
+	uint8_t hash_der[AUTH_OFFLOAD_HASH_DER_SIZE];
+	bool done;
+	int rc;
+} auth_offload_job_t;
+
+/*
+ * Jobs are submitted and collected by the loader in load order, and taken by
+ * the worker in the same order. The indices are free running:
+ *
+ *   jobs_tail <= jobs_next <= jobs_head <= jobs_tail + PLAT_AUTH_OFFLOAD_JOBS
+ *
+ * Everything below is protected by 'jobs_lock'. The lock is only taken with
+ * the MMU and data cache enabled on both sides.
+ */
+static auth_offload_job_t jobs[PLAT_AUTH_OFFLOAD_JOBS];
+static unsigned int jobs_head;		/* Next slot to submit */
+static unsigned int jobs_next;		/* Next slot for the worker */
+static unsigned int jobs_tail;		/* Next slot to collect */
+static bool worker_running;
+static bool worker_stop;
+static bool worker_exited;
+static spinlock_t jobs_lock;
+
+/*
+ * Release the worker core. Hash verification falls back to the loading core
+ * if the platform cannot provide one.
+ */
+int auth_offload_init(void)
+{
+	int rc;
+
+	rc = plat_auth_worker_start();
+	if (rc != 0) {
+		VERBOSE("Image hashes are verified synchronously (%d)\n", rc);
+		return rc;
+	}
+
+	worker_running = true;
+
+	return 0;
+}
+
+/*
+ * Queue the hash verification of an image which has just been loaded.
+ *
+ * Return value:
+ *   0 = the image is verified by the worker, its result must be collected
+ *       with auth_offload_wait() before the image is used,
+ *   otherwise = the caller must authenticate the image itself
+ */
+int auth_offload_submit(unsigned int img_id, const image_info_t *image_data)
+{
+	auth_offload_job_t *job;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+
+	if (!worker_running) {
+		return -ENODEV;
+	}
+
+	if (auth_mod_get_img_hash(img_id, &hash_der_ptr, &hash_der_len) != 0) {
+		return -ENOTSUP;
+	}
+
+	if (hash_der_len > AUTH_OFFLOAD_HASH_DER_SIZE) {
+		return -ENOMEM;
+	}
+
+	spin_lock(&jobs_lock);
+
+	if ((jobs_head - jobs_tail) == PLAT_AUTH_OFFLOAD_JOBS) {
+		spin_unlock(&jobs_lock);
+		return -EBUSY;
+	}
+
+	/*
+	 * The hash is copied, as the parent's parameter buffer may be refilled
+	 * while the worker is busy with this image.
+	 */
+	job = &jobs[JOB_IDX(jobs_head)];
+	job->img_id = img_id;
+	job->img_base = image_data->image_base;
+	job->img_len = image_data->image_size;
+	job->hash_der_len = hash_der_len;
+	memcpy(job->hash_der, hash_der_ptr, hash_der_len);
+	job->done = false;
+	job->rc = 0;
+	jobs_head++;
+
+	spin_unlock(&jobs_lock);
+
+	dsbish();
+	sev();
+
+	return 0;
+}
+
+static auth_offload_job_t *find_job(unsigned int img_id)
+{
+	unsigned int i;
+
+	for (i = jobs_tail; i != jobs_head; i++) {
+		if (jobs[JOB_IDX(i)].img_id == img_id) {
+			return &jobs[JOB_IDX(i)];
+		}
+	}
+
+	return NULL;
+}
+
+bool auth_offload_is_pending(unsigned int img_id)
+{
+	bool pending;
+
+	spin_lock(&jobs_lock);
+	pending = (find_job(img_id) != NULL);
+	spin_unlock(&jobs_lock);
+
+	return pending;
+}
+
+/*
+ * Collect the result of an offloaded image. Images must be collected in the
+ * order they were submitted. An image which failed the verification is wiped
+ * before returning.
+ *
+ * Return: 0 = success, -EAUTH = the image is not authentic
+ */
+int auth_offload_wait(unsigned int img_id)
+{
+	auth_offload_job_t *job;
+	uintptr_t img_base;
+	unsigned int img_len;
+	int rc;
+
+	spin_lock(&jobs_lock);
+	job = find_job(img_id);
+	assert(job == &jobs[JOB_IDX(jobs_tail)]);
+
+	while (!job->done) {
+		spin_unlock(&jobs_lock);
+		wfe();
+		spin_lock(&jobs_lock);
+	}
+
+	img_base = job->img_base;
+	img_len = job->img_len;
+	rc = job->rc;
+	jobs_tail++;
+	spin_unlock(&jobs_lock);
+
+	if (rc != 0) {
+		WARN("Offloaded authentication of image id=%u failed (%d)\n",
+		      img_id, rc);
+		zero_normalmem((void *)img_base, img_len);
+		flush_dcache_range(img_base, img_len);
+		return -EAUTH;
+	}
+
+	return 0;
+}
+
+/*
+ * Stop the worker once every queued job has been collected and give its core
+ * back to the platform.
+ */
+void auth_offload_exit(void)
+{
+	if (!worker_running) {
+		return;
+	}
+
+	spin_lock(&jobs_lock);
+	assert(jobs_tail == jobs_head);
+	worker_stop = true;
+	spin_unlock(&jobs_lock);
+
+	dsbish();
+	sev();
+
+	spin_lock(&jobs_lock);
+	while (!worker_exited) {
+		spin_unlock(&jobs_lock);
+		wfe();
+		spin_lock(&jobs_lock);
+	}
+	spin_unlock(&jobs_lock);
+
+	plat_auth_worker_stop();
+	worker_running = false;
+}
+
+void auth_offload_worker(void)
+{
+	auth_offload_job_t *job;
+	int rc;
+
+	spin_lock(&jobs_lock);
+
+	while (!worker_stop || (jobs_next != jobs_head)) {
+		if (jobs_next == jobs_head) {
+			spin_unlock(&jobs_lock);
+			wfe();
+			spin_lock(&jobs_lock);
+			continue;
+		}
+
+		job = &jobs[JOB_IDX(jobs_next)];
+		spin_unlock(&jobs_lock);
+
+		rc = auth_mod_verify_img_hash(job->img_id,
+					      (void *)job->img_base,
+					      job->img_len,
+					      job->hash_der,
+					      job->hash_der_len);
+
+		spin_lock(&jobs_lock);
+		job->rc = rc;
+		job->done = true;
+		jobs_next++;
+		dsbish();
+		sev();
+	}
+
+	worker_exited = true;
+	spin_unlock(&jobs_lock);
+
+	dsbish();
+	sev();
+}
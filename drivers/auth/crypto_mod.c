@@ -125,6 +125,51 @@ int crypto_mod_calc_hash(unsigned int alg, void *data_ptr,
 }
 #endif	/* MEASURED_BOOT */
 
+#if INCREMENTAL_AUTH_HASH
+/*
+ * Start an incremental hash calculation
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared at the end
+ */
+int crypto_mod_hash_start(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	assert(crypto_hash_lib_desc.hash_start != NULL);
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	return crypto_hash_lib_desc.hash_start(digest_info_ptr,
+					       digest_info_len);
+}
+
+/*
+ * Add a chunk of data to the ongoing hash calculation
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: data to be hashed
+ */
+int crypto_mod_hash_update(const void *data_ptr, unsigned int data_len)
+{
+	assert(crypto_hash_lib_desc.hash_update != NULL);
+	assert(data_ptr != NULL);
+
+	return crypto_hash_lib_desc.hash_update(data_ptr, data_len);
+}
+
+/*
+ * Finish the ongoing hash calculation and compare the result with the digest
+ * passed to crypto_mod_hash_start()
+ */
+int crypto_mod_hash_verify(void)
+{
+	assert(crypto_hash_lib_desc.hash_verify != NULL);
+
+	return crypto_hash_lib_desc.hash_verify();
+}
+#endif	/* INCREMENTAL_AUTH_HASH */
+
 /*
  * Authenticated decryption of data
  *
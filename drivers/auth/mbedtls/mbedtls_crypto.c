@@ -140,19 +140,18 @@ end2:
 }
 
 /*
- * Match a hash
+ * Parse a DigestInfo structure
  *
- * Digest info is passed in DER format following the ASN.1 structure detailed
- * above.
+ * On success, 'md_info' describes the hash algorithm and 'hash' points to the
+ * digest inside the DER buffer.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -176,8 +175,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -188,10 +187,32 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != 0) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
@@ -209,6 +230,90 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+#if INCREMENTAL_AUTH_HASH
+static mbedtls_md_context_t hash_ctx;
+static const mbedtls_md_info_t *hash_md_info;
+static unsigned char hash_expected[MBEDTLS_MD_MAX_SIZE];
+
+/*
+ * Start an incremental hash calculation
+ *
+ * The expected digest is copied out of the DigestInfo, so the caller's buffer
+ * does not need to outlive this call.
+ */
+static int hash_start(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	/* Drop any calculation left behind by a failed load */
+	mbedtls_md_free(&hash_ctx);
+	mbedtls_md_init(&hash_ctx);
+	hash_md_info = NULL;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != 0) {
+		return rc;
+	}
+	memcpy(hash_expected, hash, mbedtls_md_get_size(md_info));
+
+	rc = mbedtls_md_setup(&hash_ctx, md_info, 0);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_starts(&hash_ctx);
+	if (rc != 0) {
+		mbedtls_md_free(&hash_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+	hash_md_info = md_info;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Add data to the ongoing hash calculation
+ */
+static int hash_update(const void *data_ptr, unsigned int data_len)
+{
+	if (hash_md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	if (mbedtls_md_update(&hash_ctx, data_ptr, data_len) != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Finish the hash calculation and match it against the expected digest
+ */
+static int hash_verify(void)
+{
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	if (hash_md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_finish(&hash_ctx, data_hash);
+	if (rc == 0) {
+		rc = memcmp(data_hash, hash_expected,
+			    mbedtls_md_get_size(hash_md_info));
+	}
+
+	mbedtls_md_free(&hash_ctx);
+	hash_md_info = NULL;
+
+	return (rc == 0) ? CRYPTO_SUCCESS : CRYPTO_ERR_HASH;
+}
+#endif /* INCREMENTAL_AUTH_HASH */
+
 #if MEASURED_BOOT
 /*
  * Calculate a hash
@@ -348,3 +453,7 @@ REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash,
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL);
 #endif
 #endif /* MEASURED_BOOT */
+
+#if INCREMENTAL_AUTH_HASH
+REGISTER_CRYPTO_HASH_LIB(hash_start, hash_update, hash_verify);
+#endif /* INCREMENTAL_AUTH_HASH */
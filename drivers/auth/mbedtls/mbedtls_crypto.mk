@@ -8,4 +8,6 @@ include drivers/auth/mbedtls/mbedtls_common.mk
 
 MBEDTLS_SOURCES	+=		drivers/auth/mbedtls/mbedtls_crypto.c
 
-
+ifeq (${AUTH_CERT_CACHE},1)
+MBEDTLS_SOURCES	+=		drivers/auth/auth_cert_cache.c
+endif
@@ -9,6 +9,7 @@
 #include <libfdt.h>
 #include <libfdt_env.h>
 #include <memory_pool.h>
+#include <s32_dt.h>
 
 #define NUM_FIXED_DRVS	22
 
@@ -79,8 +80,8 @@ int dt_init_fixed_clk(void *fdt)
 
 	node = -1;
 	while (true) {
-		node = fdt_node_offset_by_compatible(fdt, node,
-						     "fixed-clock");
+		node = dt_node_offset_by_compatible(fdt, node,
+						    "fixed-clock");
 		if (node == -1)
 			break;
 
@@ -29,6 +29,7 @@
  */
 
 #include "ddr_init.h"
+#include <s32_bootchart.h>
 
 static uint32_t ddrc_init_cfg(const struct ddrss_config *config);
 static uint32_t execute_training(const struct ddrss_config *config);
@@ -55,9 +56,11 @@ uint32_t ddr_init(void)
 			return ret;
 
 		/* Init PHY module */
+		s32_bootchart_mark(S32_BOOT_DDR_TRAINING, i);
 		ret = execute_training(&configs[i]);
 		if (ret != NO_ERR)
 			return ret;
+		s32_bootchart_mark(S32_BOOT_DDR_TRAINED, i);
 
 		/* Execute post training setup */
 		ret = post_train_setup((uint8_t)(STORE_CSR_MASK |
@@ -66,6 +69,8 @@ uint32_t ddr_init(void)
 		if (ret != NO_ERR)
 			return ret;
 	}
+
+	s32_bootchart_mark(S32_BOOT_DDR, 0);
 	return ret;
 }
 
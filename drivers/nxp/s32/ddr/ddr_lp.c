@@ -28,20 +28,92 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <stddef.h>
+
 #include "ddr_lp.h"
 #include "ddr_init.h"
 
+/*
+ * Registers saved at 'store_at' by store_csr() and store_ddrc_regs():
+ *
+ *   struct lp_store_hdr
+ *   uint32_t ddrc[ddrc_to_store_size]
+ *   uint32_t repeat_map[LP_MAP_WORDS(csr_to_store_size)]
+ *   uint16_t csr[csr_count], two per word, padded to a word
+ *
+ * Bit 'i' of the repeat map is set when csr_to_store[i] holds the same value
+ * as the CSR listed before it, in which case the value is not stored. The
+ * same register of each DBYTE/ANIB instance is listed in a row and most of
+ * them end up with the same trained value.
+ *
+ * Each section has its own CRC, as the DDRC registers are saved later than
+ * the CSRs. Both are checked before anything is restored.
+ */
+#define LP_STORE_MAGIC		0x4c50U
+#define LP_MAP_WORDS(n)		(((n) + 31U) / 32U)
+
+struct lp_store_hdr {
+	uint16_t magic;
+	uint16_t csr_count;
+	uint32_t csr_crc;
+	uint32_t ddrc_crc;
+};
+
+static const uint32_t crc32_nibble[16] = {
+	0x00000000U, 0x1db71064U, 0x3b6e20c8U, 0x26d930acU,
+	0x76dc4190U, 0x6b6b51f4U, 0x4db26158U, 0x5005713cU,
+	0xedb88320U, 0xf00f9344U, 0xd6d6a3e8U, 0xcb61b38cU,
+	0x9b64c2b0U, 0x86d3d2d4U, 0xa00ae278U, 0xbdbdf21cU,
+};
+
 static void load_csr(uintptr_t load_from);
 static void load_ddrc_regs(uintptr_t load_from);
 
 #pragma weak ddrss_gpr_to_io_retention_mode
 
+static uintptr_t ddrc_section(uintptr_t base)
+{
+	return base + sizeof(struct lp_store_hdr);
+}
+
+static uintptr_t map_section(uintptr_t base)
+{
+	return ddrc_section(base) + (ddrc_to_store_size * sizeof(uint32_t));
+}
+
+static uintptr_t csr_section(uintptr_t base)
+{
+	return map_section(base) +
+	       (LP_MAP_WORDS(csr_to_store_size) * sizeof(uint32_t));
+}
+
+/* CRC-32 (IEEE 802.3) of 'words' little-endian words. */
+static uint32_t lp_crc32(uintptr_t addr, size_t words)
+{
+	uint32_t crc = 0xffffffffU;
+	uint32_t word;
+	size_t i, j;
+
+	for (i = 0; i < words; i++) {
+		word = mmio_read_32(addr + (i * sizeof(uint32_t)));
+		for (j = 0; j < 8U; j++) {
+			crc ^= word & 0xfU;
+			crc = (crc >> 4) ^ crc32_nibble[crc & 0xfU];
+			word >>= 4;
+		}
+	}
+
+	return ~crc;
+}
+
 /* Store Configuration Status Registers. */
 void store_csr(uintptr_t store_at)
 {
-	size_t i;
-	uint16_t csr;
-	uintptr_t current_addr = store_at;
+	size_t i, count = 0;
+	uint16_t csr, prev = 0;
+	uint32_t map = 0, pending = 0;
+	uintptr_t map_addr = map_section(store_at);
+	uintptr_t current_addr = csr_section(store_at);
 
 	mmio_write_32(MICROCONT_MUX_SEL, UNLOCK_CSR_ACCESS);
 	mmio_write_32(DDR_PHYA_UCCLKHCLKENABLES, HCLKEN_MASK | UCCLKEN_MASK);
@@ -49,24 +121,69 @@ void store_csr(uintptr_t store_at)
 	for (i = 0; i < csr_to_store_size; i++) {
 		csr = mmio_read_16((uint32_t)(DDRSS_BASE_ADDR +
 					      csr_to_store[i]));
-		mmio_write_16(current_addr, csr);
-		current_addr += sizeof(uint16_t);
+
+		if ((i != 0U) && (csr == prev)) {
+			map |= (uint32_t)1U << (i % 32U);
+		} else if ((count++ % 2U) == 0U) {
+			pending = csr;
+		} else {
+			mmio_write_32(current_addr,
+				      pending | ((uint32_t)csr << 16));
+			current_addr += sizeof(uint32_t);
+		}
+		prev = csr;
+
+		if (((i % 32U) == 31U) || (i == (csr_to_store_size - 1U))) {
+			mmio_write_32(map_addr, map);
+			map_addr += sizeof(uint32_t);
+			map = 0;
+		}
+	}
+
+	if ((count % 2U) != 0U) {
+		mmio_write_32(current_addr, pending);
+		current_addr += sizeof(uint32_t);
 	}
 
 	mmio_write_32(DDR_PHYA_UCCLKHCLKENABLES, HCLKEN_MASK);
 	mmio_write_32(MICROCONT_MUX_SEL, LOCK_CSR_ACCESS);
+
+	mmio_write_16(store_at + offsetof(struct lp_store_hdr, magic),
+		      LP_STORE_MAGIC);
+	mmio_write_16(store_at + offsetof(struct lp_store_hdr, csr_count),
+		      (uint16_t)count);
+	mmio_write_32(store_at + offsetof(struct lp_store_hdr, csr_crc),
+		      lp_crc32(map_section(store_at),
+			       (current_addr - map_section(store_at)) /
+			       sizeof(uint32_t)));
 }
 
 /* Load Configuration Status Registers. */
 static void load_csr(uintptr_t load_from)
 {
-	size_t i;
-	uint16_t csr;
-	uintptr_t current_addr = load_from;
+	size_t i, count = 0;
+	uint16_t csr = 0;
+	uint32_t map = 0, word = 0;
+	uintptr_t map_addr = map_section(load_from);
+	uintptr_t current_addr = csr_section(load_from);
 
 	for (i = 0; i < csr_to_store_size; i++) {
-		csr = mmio_read_16(current_addr);
-		current_addr += sizeof(uint16_t);
+		if ((i % 32U) == 0U) {
+			map = mmio_read_32(map_addr);
+			map_addr += sizeof(uint32_t);
+		}
+
+		/* A repeated value is written again as is */
+		if ((map & ((uint32_t)1U << (i % 32U))) == 0U) {
+			if ((count++ % 2U) == 0U) {
+				word = mmio_read_32(current_addr);
+				current_addr += sizeof(uint32_t);
+				csr = (uint16_t)word;
+			} else {
+				csr = (uint16_t)(word >> 16);
+			}
+		}
+
 		mmio_write_16((uint32_t)(DDRSS_BASE_ADDR + csr_to_store[i]),
 			      csr);
 	}
@@ -77,10 +194,7 @@ void store_ddrc_regs(uintptr_t store_at)
 {
 	size_t i;
 	uint32_t value;
-	uintptr_t current_addr = store_at;
-	/* DDRC registers are stored right after the CSRs */
-	current_addr += sizeof(uint16_t) * csr_to_store_size;
-	current_addr += sizeof(uint32_t) - (current_addr % sizeof(uint32_t));
+	uintptr_t current_addr = ddrc_section(store_at);
 
 	for (i = 0; i < ddrc_to_store_size; i++) {
 		value = mmio_read_32((uint32_t)(DDRC_BASE_ADDR +
@@ -88,6 +202,9 @@ void store_ddrc_regs(uintptr_t store_at)
 		mmio_write_32(current_addr, value);
 		current_addr += sizeof(uint32_t);
 	}
+
+	mmio_write_32(store_at + offsetof(struct lp_store_hdr, ddrc_crc),
+		      lp_crc32(ddrc_section(store_at), ddrc_to_store_size));
 }
 
 /* Load DDRC registers. */
@@ -95,10 +212,7 @@ static void load_ddrc_regs(uintptr_t load_from)
 {
 	size_t i;
 	uint32_t value;
-	uintptr_t current_addr = load_from;
-	/* DDRC registers are stored right after the CSRs */
-	current_addr += sizeof(uint16_t) * csr_to_store_size;
-	current_addr += sizeof(uint32_t) - (current_addr % sizeof(uint32_t));
+	uintptr_t current_addr = ddrc_section(load_from);
 
 	for (i = 0; i < ddrc_to_store_size; i++) {
 		value = mmio_read_32(current_addr);
@@ -108,6 +222,39 @@ static void load_ddrc_regs(uintptr_t load_from)
 	}
 }
 
+/* Check the registers saved by store_csr() and store_ddrc_regs(). */
+static uint32_t check_stored_regs(uintptr_t load_from)
+{
+	size_t i, count = csr_to_store_size;
+	size_t map_words = LP_MAP_WORDS(csr_to_store_size);
+	uintptr_t map_addr = map_section(load_from);
+	uint32_t crc;
+
+	if (mmio_read_16(load_from + offsetof(struct lp_store_hdr, magic)) !=
+	    LP_STORE_MAGIC)
+		return STORED_REGS_CORRUPTED;
+
+	for (i = 0; i < map_words; i++)
+		count -= (size_t)__builtin_popcount(mmio_read_32(map_addr +
+						(i * sizeof(uint32_t))));
+
+	if (count != mmio_read_16(load_from +
+				  offsetof(struct lp_store_hdr, csr_count)))
+		return STORED_REGS_CORRUPTED;
+
+	crc = lp_crc32(map_addr, map_words + ((count + 1U) / 2U));
+	if (crc != mmio_read_32(load_from +
+				offsetof(struct lp_store_hdr, csr_crc)))
+		return STORED_REGS_CORRUPTED;
+
+	crc = lp_crc32(ddrc_section(load_from), ddrc_to_store_size);
+	if (crc != mmio_read_32(load_from +
+				offsetof(struct lp_store_hdr, ddrc_crc)))
+		return STORED_REGS_CORRUPTED;
+
+	return NO_ERR;
+}
+
 void ddrss_gpr_to_io_retention_mode_mmio(void)
 {
 	uint32_t tmp32;
@@ -251,6 +398,10 @@ uint32_t ddrss_to_normal_mode(uintptr_t csr_array)
 {
 	uint32_t pwrctl, init0, ret;
 
+	ret = check_stored_regs(csr_array);
+	if (ret != NO_ERR)
+		return ret;
+
 	ret = load_register_cfg(ddrc_cfg_size, ddrc_cfg);
 	load_ddrc_regs(csr_array);
 	if (ret != NO_ERR)
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #include <drivers/nxp/linflexuart.h>
+#include <errno.h>
 #include <lib/mmio.h>
 
 #define LDIV_MULTIPLIER		(16)
@@ -125,23 +126,22 @@ void console_linflex_flush(struct console *console)
 	return;
 }
 
-int console_linflex_putc(int character, struct console *console)
+int console_linflex_tx(struct console *console, uint8_t byte, bool wait)
 {
 	uintptr_t base = console->base;
 	uint32_t uartsr;
 
-	if (character == '\n')
-		console_linflex_putc('\r', console);
-
 	/* UART is in FIFO mode */
 	if (linflex_read(base, LINFLEX_UARTCR) & UARTCR_TFBM) {
-		while (linflex_read(base, LINFLEX_UARTSR) & UARTSR_DTF)
-			;
+		while (linflex_read(base, LINFLEX_UARTSR) & UARTSR_DTF) {
+			if (!wait)
+				return -EAGAIN;
+		}
 
-		mmio_write_8(base + LINFLEX_BDRL, character);
+		mmio_write_8(base + LINFLEX_BDRL, byte);
 	} else {
 		/* UART is in Buffer mode */
-		mmio_write_8(base + LINFLEX_BDRL, character);
+		mmio_write_8(base + LINFLEX_BDRL, byte);
 
 		do {
 			uartsr = linflex_read(base, LINFLEX_UARTSR);
@@ -156,3 +156,11 @@ int console_linflex_putc(int character, struct console *console)
 
 	return 0;
 }
+
+int console_linflex_putc(int character, struct console *console)
+{
+	if (character == '\n')
+		console_linflex_putc('\r', console);
+
+	return console_linflex_tx(console, (uint8_t)character, true);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef BOOT_INSTR_H
+#define BOOT_INSTR_H
+
+#include <stdint.h>
+
+#include <arch_helpers.h>
+
+/*
+ * Boot path instrumentation (ENABLE_BOOT_INSTRUMENTATION=1): the duration of
+ * the image loading, authentication and decompression, of the translation
+ * tables setup and of the PSCI CPU_ON and CPU_OFF paths, in system counter
+ * ticks. The measurements are stored, then printed by boot_instr_print() at
+ * the end of each image and after the measured PSCI calls, as lines of
+ * comma-separated values, regardless of the log level:
+ *
+ *   BOOT_INSTR,<image>,<event>,<id>,<ticks>
+ *
+ * The first line printed by an image gives the counter frequency, as event
+ * 'freq'. The lines are parsed by tools/boot_instr/boot_instr.py.
+ */
+
+#if ENABLE_BOOT_INSTRUMENTATION
+static inline uint64_t boot_instr_start(void)
+{
+	isb();
+	return read_cntpct_el0();
+}
+
+void boot_instr_end(const char *event, unsigned int id, uint64_t start);
+void boot_instr_print(void);
+#else
+static inline uint64_t boot_instr_start(void)
+{
+	return 0;
+}
+
+static inline void boot_instr_end(const char *event, unsigned int id,
+				  uint64_t start)
+{
+}
+
+static inline void boot_instr_print(void)
+{
+}
+#endif /* ENABLE_BOOT_INSTRUMENTATION */
+
+#endif /* BOOT_INSTR_H */
@@ -111,5 +111,15 @@ void __dead2 __stack_chk_fail(void);
 void tf_log(const char *fmt, ...) __printflike(1, 2);
 void tf_log_set_max_level(unsigned int log_level);
 
+#if ENABLE_LOG_BUFFER
+int tf_log_buffer_init(uintptr_t base, size_t size, bool new_boot);
+#else
+static inline int tf_log_buffer_init(uintptr_t base, size_t size,
+				     bool new_boot)
+{
+	return 0;
+}
+#endif
+
 #endif /* __ASSEMBLER__ */
 #endif /* DEBUG_H */
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AUTH_CERT_CACHE_H
+#define AUTH_CERT_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define AUTH_CERT_CACHE_ENTRIES		8U
+#define AUTH_CERT_CACHE_HASH_SIZE	32U	/* SHA-256 */
+
+/* A certificate which passed all its authentication methods */
+typedef struct auth_cert_cache_entry_s {
+	uint32_t img_id;
+	uint8_t hash[AUTH_CERT_CACHE_HASH_SIZE];
+} auth_cert_cache_entry_t;
+
+typedef struct auth_cert_cache_s {
+	uint32_t num_entries;
+	auth_cert_cache_entry_t entries[AUTH_CERT_CACHE_ENTRIES];
+} auth_cert_cache_t;
+
+int auth_cert_cache_hash(const void *img_ptr, unsigned int img_len,
+			 uint8_t *hash);
+bool auth_cert_cache_lookup(unsigned int img_id, const uint8_t *hash);
+void auth_cert_cache_add(unsigned int img_id, const uint8_t *hash);
+
+#endif /* AUTH_CERT_CACHE_H */
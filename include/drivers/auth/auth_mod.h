@@ -51,6 +51,19 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+#if INCREMENTAL_AUTH_HASH
+int auth_mod_hash_start(unsigned int img_id);
+int auth_mod_hash_update(const void *ptr, unsigned int len);
+#endif
+#if PARALLEL_IMAGE_AUTH
+int auth_mod_get_img_hash(unsigned int img_id, void **hash_der_ptr,
+			  unsigned int *hash_der_len);
+int auth_mod_verify_img_hash(unsigned int img_id,
+			     void *img_ptr,
+			     unsigned int img_len,
+			     void *hash_der_ptr,
+			     unsigned int hash_der_len);
+#endif
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t pointers */
 #define REGISTER_COT(_cot) \
@@ -0,0 +1,24 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AUTH_OFFLOAD_H
+#define AUTH_OFFLOAD_H
+
+#include <stdbool.h>
+
+#include <common/bl_common.h>
+
+/* Loader side */
+int auth_offload_init(void);
+int auth_offload_submit(unsigned int img_id, const image_info_t *image_data);
+bool auth_offload_is_pending(unsigned int img_id);
+int auth_offload_wait(unsigned int img_id);
+void auth_offload_exit(void);
+
+/* Runs on the core released by plat_auth_worker_start() */
+void auth_offload_worker(void);
+
+#endif /* AUTH_OFFLOAD_H */
@@ -107,4 +107,39 @@ int crypto_mod_calc_hash(unsigned int alg, void *data_ptr,
 
 extern const crypto_lib_desc_t crypto_lib_desc;
 
+#if INCREMENTAL_AUTH_HASH
+/*
+ * Incremental hash descriptor. Only one hash calculation is in flight at any
+ * given time, so the context is owned by the cryptographic library.
+ */
+typedef struct crypto_hash_lib_desc_s {
+	/* Start a hash calculation for the algorithm in 'digest_info' and
+	 * remember the expected digest. Return one of the
+	 * 'enum crypto_ret_value' options */
+	int (*hash_start)(void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Feed data into the ongoing hash calculation. Return one of the
+	 * 'enum crypto_ret_value' options */
+	int (*hash_update)(const void *data_ptr, unsigned int data_len);
+
+	/* Finish the calculation and compare the result with the expected
+	 * digest. Return one of the 'enum crypto_ret_value' options */
+	int (*hash_verify)(void);
+} crypto_hash_lib_desc_t;
+
+int crypto_mod_hash_start(void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_update(const void *data_ptr, unsigned int data_len);
+int crypto_mod_hash_verify(void);
+
+/* Macro to register the incremental hash operations of a cryptographic library */
+#define REGISTER_CRYPTO_HASH_LIB(_hash_start, _hash_update, _hash_verify) \
+	const crypto_hash_lib_desc_t crypto_hash_lib_desc = { \
+		.hash_start = _hash_start, \
+		.hash_update = _hash_update, \
+		.hash_verify = _hash_verify \
+	}
+
+extern const crypto_hash_lib_desc_t crypto_hash_lib_desc;
+#endif /* INCREMENTAL_AUTH_HASH */
+
 #endif /* CRYPTO_MOD_H */
@@ -7,6 +7,8 @@
 #define LINFLEXUART_H
 
 #ifndef __ASSEMBLER__
+#include <stdbool.h>
+
 #include <drivers/console.h>
 
 struct console_linflex {
@@ -19,6 +21,11 @@ struct console_linflex {
 int console_linflex_register(struct console_linflex *console);
 int console_linflex_putc(int character, struct console *console);
 void console_linflex_flush(struct console *console);
+/*
+ * Sends a byte as is. In FIFO mode, returns -EAGAIN instead of waiting if the
+ * TX FIFO is full and 'wait' is false.
+ */
+int console_linflex_tx(struct console *console, uint8_t byte, bool wait);
 #endif
 
 #endif /* LINFLEXUART_H */
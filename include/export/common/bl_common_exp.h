@@ -25,6 +25,11 @@
 
 #define IMAGE_ATTRIB_SKIP_LOADING	U(0x02)
 #define IMAGE_ATTRIB_PLAT_SETUP		U(0x04)
+/*
+ * The post-load handling of the image may wait until the next image has been
+ * loaded, so that its authentication can run in the background.
+ */
+#define IMAGE_ATTRIB_ASYNC_AUTH		U(0x08)
 
 #define INVALID_IMAGE_ID		U(0xFFFFFFFF)
 
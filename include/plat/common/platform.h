@@ -208,6 +208,11 @@ int bl2_plat_handle_post_image_load(unsigned int image_id);
 /* Read TCG_DIGEST_SIZE bytes of BL2 hash data */
 void bl2_plat_get_hash(void *data);
 #endif
+#if PARALLEL_IMAGE_AUTH
+/* Release and park the core which authenticates images in the background */
+int plat_auth_worker_start(void);
+void plat_auth_worker_stop(void);
+#endif
 
 /*******************************************************************************
  * Mandatory BL2 at EL3 functions: Must be implemented if BL2_AT_EL3 image is
@@ -10,13 +10,26 @@
 
 #define CSR_SETTING_OFFSET offsetof(struct s32g_ssram_mailbox, csr_settings)
 #define BL31SSRAM_CSR_BASE (BL31SSRAM_MAILBOX + CSR_SETTING_OFFSET)
-#define BL31SSRAM_CSR_SIZE (0x2CC)
+/*
+ * Saved DDR registers, see ddr_lp.c. Worst case, with no repeated CSR value:
+ * 12 bytes of header, 6 DDRC registers, a 44 bytes repeat map and 338 CSRs.
+ */
+#define BL31SSRAM_CSR_SIZE (0x300)
+
+/* Resume milestones, see s32g_resume_trace.c */
+#define S32G_RESUME_TRACE_SLOTS	(8)
 
 typedef void (*s32g_warm_entrypoint_t)(void);
 
+struct s32g_resume_trace {
+	uint32_t valid;
+	uint32_t ticks[S32G_RESUME_TRACE_SLOTS];
+};
+
 struct s32g_ssram_mailbox {
 	s32g_warm_entrypoint_t bl31_warm_entrypoint __aligned(2);
 	uint8_t csr_settings[BL31SSRAM_CSR_SIZE] __aligned(4);
+	struct s32g_resume_trace resume_trace __aligned(4);
 };
 
 #endif
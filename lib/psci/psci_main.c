@@ -9,6 +9,7 @@
 
 #include <arch.h>
 #include <arch_helpers.h>
+#include <common/boot_instr.h>
 #include <common/debug.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
@@ -43,7 +44,12 @@ int psci_cpu_on(u_register_t target_cpu,
 	 * To turn this cpu on, specify which power
 	 * levels need to be turned on
 	 */
-	return psci_cpu_on_start(target_cpu, &ep);
+	rc = psci_cpu_on_start(target_cpu, &ep);
+
+	/* Outside of the measured path */
+	boot_instr_print();
+
+	return rc;
 }
 
 unsigned int psci_version(void)
@@ -9,6 +9,7 @@
 
 #include <arch.h>
 #include <arch_helpers.h>
+#include <common/boot_instr.h>
 #include <common/debug.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
@@ -46,6 +47,7 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	unsigned int idx = plat_my_core_pos();
 	psci_power_state_t state_info;
 	unsigned int parent_nodes[PLAT_MAX_PWR_LVL] = {0};
+	uint64_t start = boot_instr_start();
 
 	/*
 	 * This function must only be called on platforms where the
@@ -165,6 +167,9 @@ exit:
 		    PMF_NO_CACHE_MAINT);
 #endif
 
+		/* Up to the point where the power controller takes over */
+		boot_instr_end("cpu_off", idx, start);
+
 		if (psci_plat_pm_ops->pwr_domain_pwr_down_wfi != NULL) {
 			/* This function must not return */
 			psci_plat_pm_ops->pwr_domain_pwr_down_wfi(&state_info);
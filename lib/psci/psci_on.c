@@ -10,6 +10,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/bl_common.h>
+#include <common/boot_instr.h>
 #include <common/debug.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/pubsub_events.h>
@@ -63,6 +64,7 @@ int psci_cpu_on_start(u_register_t target_cpu,
 	aff_info_state_t target_aff_state;
 	int ret = plat_core_pos_by_mpidr(target_cpu);
 	unsigned int target_idx = (unsigned int)ret;
+	uint64_t start = boot_instr_start();
 
 	/* Calling function must supply valid input arguments */
 	assert(ret >= 0);
@@ -158,6 +160,7 @@ int psci_cpu_on_start(u_register_t target_cpu,
 
 exit:
 	psci_spin_unlock_cpu(target_idx);
+	boot_instr_end("cpu_on", target_idx, start);
 	return rc;
 }
 
@@ -9,6 +9,7 @@
 
 #include <platform_def.h>
 
+#include <common/boot_instr.h>
 #include <common/debug.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
@@ -107,7 +108,11 @@ void __init init_xlat_tables(void)
 		tf_xlat_ctx.xlat_regime = EL3_REGIME;
 	}
 
+	uint64_t start = boot_instr_start();
+
 	init_xlat_tables_ctx(&tf_xlat_ctx);
+
+	boot_instr_end("xlat", (unsigned int)tf_xlat_ctx.xlat_regime, start);
 }
 
 int xlat_get_mem_attributes(uintptr_t base_va, uint32_t *attr)
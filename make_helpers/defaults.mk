@@ -26,6 +26,10 @@ ARM_ARCH_FEATURE		:= none
 ARM_ARCH_MAJOR			:= 8
 ARM_ARCH_MINOR			:= 0
 
+# Skip the signature checks of certificates already verified by the same boot
+# stage
+AUTH_CERT_CACHE			:= 0
+
 # Base commit to perform code check on
 BASE_COMMIT			:= origin/master
 
@@ -90,6 +94,9 @@ DISABLE_MTPMU			:= 0
 # development platforms.
 DYN_DISABLE_AUTH		:= 0
 
+# Flag to also append the log to a memory region given by the platform
+ENABLE_LOG_BUFFER		:= 0
+
 # Build option to enable MPAM for lower ELs
 ENABLE_MPAM_FOR_LOWER_ELS	:= 0
 
@@ -102,6 +109,9 @@ ENABLE_PMF			:= 0
 # Flag to enable PSCI STATs functionality
 ENABLE_PSCI_STAT		:= 0
 
+# Flag to enable the instrumentation of the boot and PSCI paths
+ENABLE_BOOT_INSTRUMENTATION	:= 0
+
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
@@ -170,6 +180,9 @@ HASH_ALG			:= sha256
 # operations.
 HW_ASSISTED_COHERENCY		:= 0
 
+# Hash images while they are loaded instead of in a separate pass over memory
+INCREMENTAL_AUTH_HASH		:= 0
+
 # Set the default algorithm for the generation of Trusted Board Boot keys
 KEY_ALG				:= rsa
 
@@ -187,6 +200,9 @@ NS_TIMER_SWITCH			:= 0
 # Include lib/libc in the final image
 OVERRIDE_LIBC			:= 0
 
+# Verify image hashes on a secondary core while BL2 loads the next image
+PARALLEL_IMAGE_AUTH		:= 0
+
 # Build PL011 UART driver in minimal generic UART mode
 PL011_GENERIC_UART		:= 0
 
@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <errno.h>
 
 #include <arch_helpers.h>
 #include <common/bl_common.h>
@@ -29,6 +30,10 @@
 #pragma weak plat_is_smccc_feature_available
 #pragma weak plat_get_soc_version
 #pragma weak plat_get_soc_revision
+#if PARALLEL_IMAGE_AUTH
+#pragma weak plat_auth_worker_start
+#pragma weak plat_auth_worker_stop
+#endif
 
 int32_t plat_get_soc_version(void)
 {
@@ -74,6 +79,21 @@ int plat_try_next_boot_source(void)
 	return 0;
 }
 
+#if PARALLEL_IMAGE_AUTH
+/*
+ * Weak implementation for platforms which cannot spare a core while BL2 is
+ * loading images: hashes are then verified by the loading core.
+ */
+int plat_auth_worker_start(void)
+{
+	return -ENOTSUP;
+}
+
+void plat_auth_worker_stop(void)
+{
+}
+#endif
+
 /*
  * Weak implementation to provide dummy decryption key only for test purposes,
  * platforms must override this API for any real world firmware encryption
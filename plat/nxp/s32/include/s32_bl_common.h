@@ -40,6 +40,8 @@
  * 0 - the core will enter in reset
  */
 #define CPU_USE_WFI_FOR_SLEEP	BIT(2)
+/* 1 - CPU is taking cluster 'c' out of the coherency domain */
+#define CLUSTER_PWRDN(c)	BIT(4 + (c))
 
 struct s32_i2c_driver {
 	struct s32_i2c_bus bus;
@@ -56,17 +58,20 @@ extern const unsigned int dtb_size;
 bool is_lockstep_enabled(void);
 
 void s32_early_plat_init(void);
+void s32_delay_timer_init(void);
 
 void s32_gic_setup(void);
 void plat_gic_save(void);
 void plat_gic_restore(void);
+void plat_gic_rdistif_online(unsigned int core);
 
 void update_core_state(uint32_t core, uint32_t mask, uint32_t flag);
 bool is_core_enabled(uint32_t core);
 uint32_t get_core_state(uint32_t core, uint32_t mask);
-bool is_last_core(void);
 bool is_cluster0_off(void);
 bool is_cluster1_off(void);
+bool is_cluster_idle(unsigned int cluster);
+bool is_cluster_pwrdn(unsigned int cluster);
 void __dead2 core_turn_off(void);
 
 struct s32_i2c_driver *s32_add_i2c_module(void *fdt, int fdt_node);
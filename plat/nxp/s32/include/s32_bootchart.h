@@ -0,0 +1,92 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef S32_BOOTCHART_H
+#define S32_BOOTCHART_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+/*
+ * Timeline of the cold boot (S32_BOOTCHART=1), from the entry of BL2 to the
+ * exit of BL31 into the next image. Each milestone is timestamped with STM6,
+ * which is shared with the SCP and the SCMI logger, and with the system
+ * counter, which counts from reset at the frequency given in the header.
+ *
+ * BL2 keeps the milestones in SRAM until the DDR is initialized, then in the
+ * 'tf-a-bootchart' reserved memory region, where BL31 appends its own. The
+ * layout below is read by the normal world, the milestones are only ever
+ * appended to this enumeration.
+ */
+
+#define S32_BOOTCHART_MAGIC		U(0x48434253)	/* "SBCH" */
+#define S32_BOOTCHART_VERSION		U(1)
+
+enum s32_boot_milestone {
+	S32_BOOT_BL2,		/* BL2 entry, with the clocks set up */
+	S32_BOOT_STORAGE,	/* Boot storage ready */
+	S32_BOOT_PMIC,		/* PMIC set up */
+	S32_BOOT_SRAM,		/* SRAM initialized */
+	S32_BOOT_DDR_TRAINING,	/* DDR PHY training started */
+	S32_BOOT_DDR_TRAINED,	/* DDR PHY training done */
+	S32_BOOT_DDR,		/* DDR initialized, including its ECC */
+	S32_BOOT_IMAGE_LOAD,	/* Image 'arg' is being loaded */
+	S32_BOOT_IMAGE_READY,	/* Image 'arg' loaded and authenticated */
+	S32_BOOT_DT_FIXUPS,	/* DT fixups of BL33 started */
+	S32_BOOT_DT_READY,	/* DTB of BL33 written */
+	S32_BOOT_BL2_EXIT,	/* BL2 done */
+	S32_BOOT_BL31,		/* BL31 entry, with the MMU set up */
+	S32_BOOT_BL31_EXIT,	/* BL31 leaving for the next image */
+	S32_BOOT_MILESTONES,
+};
+
+struct s32_bootchart_entry {
+	uint16_t milestone;
+	uint16_t arg;
+	uint32_t stm;
+	uint64_t syscnt;
+};
+
+struct s32_bootchart {
+	uint32_t magic;
+	uint32_t version;
+	/* Entries written, out of 'max_entries' */
+	uint32_t n_entries;
+	uint32_t max_entries;
+	/* Of the system counter */
+	uint64_t syscnt_freq;
+	uint64_t reserved;
+	struct s32_bootchart_entry entries[];
+};
+
+#if S32_BOOTCHART
+void s32_bootchart_start(void);
+int s32_bootchart_init(uintptr_t base, size_t size);
+void s32_bootchart_mark(enum s32_boot_milestone milestone, unsigned int arg);
+void s32_bootchart_print(void);
+#else
+static inline void s32_bootchart_start(void)
+{
+}
+
+static inline int s32_bootchart_init(uintptr_t base, size_t size)
+{
+	return 0;
+}
+
+static inline void s32_bootchart_mark(enum s32_boot_milestone milestone,
+				      unsigned int arg)
+{
+}
+
+static inline void s32_bootchart_print(void)
+{
+}
+#endif /* S32_BOOTCHART */
+
+#endif /* S32_BOOTCHART_H */
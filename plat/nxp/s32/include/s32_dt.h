@@ -31,4 +31,21 @@ int fdt_get_irq_props_by_index(const void *dtb, int node, unsigned int irq_cell_
 int fdt_node_offset_by_prop_found(const void *fdt, int startoffset,
 				  const char *propname);
 
+/* Indexed lookups, for device trees which are only read */
+int dt_node_offset_by_compatible(const void *fdt, int startoffset,
+				 const char *compatible);
+int dt_node_offset_by_phandle(const void *fdt, uint32_t phandle);
+int dt_path_offset(const void *fdt, const char *path);
+
+/* Fixups of a device tree, written at once to a copy of it */
+void dt_fixup_init(const void *fdt);
+int dt_fixup_setprop(int node, const char *name, const void *val, int len);
+int dt_fixup_setprop_u32(int node, const char *name, uint32_t val);
+int dt_fixup_setprop_string(int node, const char *name, const char *str);
+int dt_fixup_delprop(int node, const char *name);
+int dt_fixup_add_subnode(int parent, const char *name);
+int dt_fixup_add_reserved_memory(const char *node_name, uintptr_t base,
+				 size_t size);
+int dt_fixup_apply(void *blob, size_t size);
+
 #endif
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef S32_DT_CONFIG_H
+#define S32_DT_CONFIG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+/*
+ * Board configuration extracted from the DTB at build time by
+ * tools/nxp/s32_dt2c (S32_DT_STATIC_CONFIG=1). It is only used if the DTB
+ * found at runtime is the one it was extracted from, otherwise the drivers
+ * parse the DTB as usual.
+ *
+ * The layout is shared with the tool, which emits designated initializers
+ * of these structures.
+ */
+
+#define S32_DT_CONFIG_MAX_CORES		8U
+#define S32_DT_CONFIG_MAX_I2C		8U
+
+/* Parts of the SCP configuration found in the DTB */
+#define S32_DT_SCP_TX			BIT_32(0)
+#define S32_DT_SCP_TX_MD		BIT_32(1)
+#define S32_DT_SCP_RX			BIT_32(2)
+#define S32_DT_SCP_RX_MD		BIT_32(3)
+
+struct s32_dt_mem {
+	uintptr_t base;
+	size_t size;
+};
+
+struct s32_dt_scp_irq {
+	uint32_t cpn;
+	uint32_t mscm_irq;
+	int irq_num;
+};
+
+struct s32_dt_scp_config {
+	uint32_t found;
+	unsigned int n_tx_mbs;
+	unsigned int n_tx_mds;
+	struct s32_dt_mem tx_mbs[S32_DT_CONFIG_MAX_CORES];
+	struct s32_dt_mem tx_mds[S32_DT_CONFIG_MAX_CORES];
+	struct s32_dt_scp_irq tx_irq;
+	struct s32_dt_mem rx_mb;
+	struct s32_dt_mem rx_md;
+	struct s32_dt_scp_irq rx_irq;
+	struct s32_dt_mem ospm_notif_mem;
+	int ospm_notif_irq;
+};
+
+struct s32_dt_i2c_config {
+	int node;
+	uintptr_t base;
+	int speed;
+};
+
+struct s32_dt_config {
+	uint32_t dtb_size;
+	uint32_t dtb_hash;
+	struct s32_dt_scp_config scp;
+	unsigned int n_i2c;
+	struct s32_dt_i2c_config i2c[S32_DT_CONFIG_MAX_I2C];
+};
+
+#if S32_DT_STATIC_CONFIG
+extern const struct s32_dt_config s32_dt_static_config;
+
+const struct s32_dt_config *dt_get_static_config(void);
+const struct s32_dt_i2c_config *dt_get_static_i2c(int node);
+#else
+static inline const struct s32_dt_config *dt_get_static_config(void)
+{
+	return NULL;
+}
+
+static inline const struct s32_dt_i2c_config *dt_get_static_i2c(int node)
+{
+	return NULL;
+}
+#endif
+
+#endif /* S32_DT_CONFIG_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022 NXP
+ * Copyright 2022-2023 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -11,6 +11,14 @@
 
 #define MAX_INTR_EL3		128
 
+/* Selects all handlers or all cores in s32_irq_get_stats() */
+#define S32_IRQ_STATS_ALL	U(0xFFFFFFFF)
+
+typedef struct s32_irq_stats {
+	uint64_t count;		/* Number of interrupts */
+	uint64_t ticks;		/* Time spent in EL3, in system counter ticks */
+} s32_irq_stats_t;
+
 /*
  * Register handler to specific GIC entrance
  * for INTR_TYPE_EL3 type of interrupt
@@ -19,4 +27,7 @@ int request_intr_type_el3(uint32_t id, interrupt_type_handler_t handler);
 
 void s32cc_el3_interrupt_config(void);
 
+int s32_irq_get_stats(unsigned int slot, unsigned int core,
+		      uint32_t *intid, s32_irq_stats_t *stats);
+
 #endif
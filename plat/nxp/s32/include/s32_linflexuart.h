@@ -1,5 +1,5 @@
 /*
- * Copyright 2019-2021 NXP
+ * Copyright 2019-2021, 2023 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,5 +8,25 @@
 
 int console_s32_register(void);
 
+#if S32_CONSOLE_RING == 1
+/* Starts writing the console to its ring, once DDR is initialized */
+void console_s32_ring_init(void);
+/* Sends the console ring to the UART, then prints to the UART only */
+void console_s32_ring_stop(void);
+/* Sends what the UART can take of the console ring, without waiting */
+void console_s32_drain(void);
+#else
+static inline void console_s32_ring_init(void)
+{
+}
+
+static inline void console_s32_ring_stop(void)
+{
+}
+
+static inline void console_s32_drain(void)
+{
+}
 #endif
 
+#endif
@@ -128,11 +128,48 @@
 #define S32_PMEM_LEN		(2 * SIZE_1M)	/* conservatively allow 2MB */
 #define S32_PMEM_START		(S32_PMEM_END - S32_PMEM_LEN + 1)
 
+/* Logs passed to Linux, at the top of the protected zone: the console ring
+ * (see s32_linflexuart.c), the log buffer (see ENABLE_LOG_BUFFER), the
+ * trace of BL31 (see s32_trace.h) and the boot timeline (see s32_bootchart.h).
+ * They are mapped non-secure, for Linux to read them coherently.
+ */
+#if S32_CONSOLE_RING == 1
+#define S32_CONSOLE_RING_SIZE	(0x10000)
+#else
+#define S32_CONSOLE_RING_SIZE	(0)
+#endif
+#define S32_CONSOLE_RING_BASE	(S32_PMEM_END - S32_CONSOLE_RING_SIZE + 1)
+
+#if ENABLE_LOG_BUFFER == 1
+#define S32_LOG_BUFFER_SIZE	(0x10000)
+#else
+#define S32_LOG_BUFFER_SIZE	(0)
+#endif
+#define S32_LOG_BUFFER_BASE	(S32_CONSOLE_RING_BASE - S32_LOG_BUFFER_SIZE)
+
+#if S32_BL31_TRACE == 1
+#define S32_TRACE_SIZE		(0x20000)
+#else
+#define S32_TRACE_SIZE		(0)
+#endif
+#define S32_TRACE_BASE		(S32_LOG_BUFFER_BASE - S32_TRACE_SIZE)
+
+#if S32_BOOTCHART == 1
+#define S32_BOOTCHART_SIZE	(0x1000)
+#else
+#define S32_BOOTCHART_SIZE	(0)
+#endif
+#define S32_BOOTCHART_BASE	(S32_TRACE_BASE - S32_BOOTCHART_SIZE)
+
+#define S32_LOGS_BASE		(S32_BOOTCHART_BASE)
+#define S32_LOGS_SIZE		(S32_CONSOLE_RING_SIZE + S32_LOG_BUFFER_SIZE + \
+				 S32_TRACE_SIZE + S32_BOOTCHART_SIZE)
+
 /* BL31 location in DDR - physical addresses only, as the MMU is not
  * configured at that point yet
  */
 #define BL31_BASE		(S32_PMEM_START)
-#define BL31_LIMIT		(S32_PMEM_END)
+#define BL31_LIMIT		(S32_LOGS_BASE - 1)
 #define BL31_SIZE		(BL31_LIMIT - BL31_BASE + 1)
 
 /* BL32 location in DDR - 22MB
@@ -188,10 +225,9 @@
 #define MSCM_BASE_ADDR		(0x40198000U)
 #define MSCM_SIZE		(0xfa0u)
 
-#if (SCMI_LOGGER == 1)
+/* Timestamps of the SCMI logger and of the S32G resume milestones */
 #define STM6_BASE_ADDR          (0x40224000UL)
 #define STM6_SIZE               (0X3000)
-#endif
 
 /**
  * Default memory map used for SCP SCMI communication:
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef S32_PMF_H
+#define S32_PMF_H
+
+#include <lib/pmf/pmf.h>
+#include <lib/utils_def.h>
+
+/* PMF service of the S32 CPU_ON path, see s32_psci.c */
+#define S32_PMF_CPU_ON_SVC_ID		U(0x20)
+
+/* Captured by the core handling the CPU_ON call */
+#define S32_PMF_CPU_ON_ENTER		U(0)
+#define S32_PMF_CPU_ON_RELEASE		U(1)
+/* Captured by the core being turned on */
+#define S32_PMF_CPU_ON_WAKE		U(2)
+#define S32_PMF_CPU_ON_FINISH		U(3)
+#define S32_PMF_CPU_ON_TOTAL_IDS	U(4)
+
+/* PMF service of the S32 CPU_OFF and CPU_SUSPEND paths, see s32_psci.c */
+#define S32_PMF_CPU_PWR_SVC_ID		U(0x21)
+
+/* CPU_OFF, up to the core parking itself. It is woken up by CPU_ON. */
+#define S32_PMF_CPU_OFF_ENTER		U(0)
+#define S32_PMF_CPU_OFF_WFI		U(1)
+/*
+ * SYSTEM_SUSPEND. WFI and WAKE are not captured, there is no power-down idle
+ * state for CPU_SUSPEND.
+ */
+#define S32_PMF_SUSPEND_ENTER		U(2)
+#define S32_PMF_SUSPEND_WFI		U(3)
+#define S32_PMF_SUSPEND_WAKE		U(4)
+#define S32_PMF_SUSPEND_FINISH		U(5)
+/* CPU_SUSPEND to the standby (retention) state */
+#define S32_PMF_STANDBY_WFI		U(6)
+#define S32_PMF_STANDBY_WAKE		U(7)
+#define S32_PMF_CPU_PWR_TOTAL_IDS	U(8)
+
+#ifndef __ASSEMBLER__
+PMF_DECLARE_CAPTURE_TIMESTAMP(s32_cpu_on_svc)
+PMF_DECLARE_GET_TIMESTAMP(s32_cpu_on_svc)
+PMF_DECLARE_CAPTURE_TIMESTAMP(s32_cpu_pwr_svc)
+PMF_DECLARE_GET_TIMESTAMP(s32_cpu_pwr_svc)
+#endif
+
+#endif /* S32_PMF_H */
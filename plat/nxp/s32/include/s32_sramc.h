@@ -29,6 +29,21 @@ struct sram_ctrl {
 	uintptr_t (*a53_to_sramc_offset)(uintptr_t addr);
 };
 
+/* SRAM controllers initializing in parallel, see s32_sram_clear_start() */
+#define S32_SRAMC_MAX_BUSY	5
+
+struct s32_sram_clear_req {
+	uintptr_t busy[S32_SRAMC_MAX_BUSY];
+	size_t n_busy;
+	uint64_t start_ticks;
+};
+
+void s32_sram_clear_init(struct s32_sram_clear_req *req);
+int s32_sram_clear_start(struct s32_sram_clear_req *req, uintptr_t start,
+			 uintptr_t end);
+int s32_ssram_clear_start(struct s32_sram_clear_req *req);
+uint64_t s32_sram_clear_wait(struct s32_sram_clear_req *req);
+
 int s32_sram_clear(uintptr_t start, uintptr_t end);
 void s32_ssram_clear(void);
 void s32_get_sramc(struct sram_ctrl **ctrls, size_t *size);
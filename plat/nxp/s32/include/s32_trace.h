@@ -0,0 +1,104 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef S32_TRACE_H
+#define S32_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+/*
+ * Binary trace of BL31 (S32_BL31_TRACE=1), for the runtime paths which cannot
+ * afford to format a log message. S32_TRACE() stores the address of its format
+ * string, up to S32_TRACE_MAX_ARGS integer arguments, the system counter and
+ * the core in a ring of the core, in the 'tf-a-trace' region. The format is
+ * only applied by tools/nxp/s32_trace, from a dump of the region and the ELF
+ * of BL31.
+ *
+ * The arguments are converted to u_register_t: the format may use any of the
+ * integer conversions, %p, and %s for the strings of BL31.
+ *
+ * The layout below is shared with the tool.
+ */
+
+#define S32_TRACE_MAGIC			U(0x43525453)	/* "STRC" */
+#define S32_TRACE_VERSION		U(1)
+#define S32_TRACE_MAX_ARGS		4U
+
+struct s32_trace_entry {
+	uint64_t time;
+	uint64_t fmt;
+	uint16_t core;
+	uint16_t nargs;
+	uint32_t reserved;
+	uint64_t args[S32_TRACE_MAX_ARGS];
+};
+
+/* Each core has a header, followed by its ring of 'n_entries' */
+struct s32_trace_core {
+	/* Number of entries written, the last 'n_entries' are kept */
+	uint64_t head;
+	uint64_t reserved[7];
+};
+
+struct s32_trace_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t n_cores;
+	uint32_t n_entries;
+	/* Size of a core header and of its entries */
+	uint32_t core_size;
+	uint32_t entry_size;
+	/* Of the system counter */
+	uint64_t freq;
+	uint64_t reserved[4];
+};
+
+#define S32_TRACE_ARG(a)	((u_register_t)(a))
+
+#define S32_TRACE_0(fmt) \
+	s32_trace_write(fmt, 0U, 0U, 0U, 0U, 0U)
+#define S32_TRACE_1(fmt, a) \
+	s32_trace_write(fmt, 1U, S32_TRACE_ARG(a), 0U, 0U, 0U)
+#define S32_TRACE_2(fmt, a, b) \
+	s32_trace_write(fmt, 2U, S32_TRACE_ARG(a), S32_TRACE_ARG(b), 0U, 0U)
+#define S32_TRACE_3(fmt, a, b, c) \
+	s32_trace_write(fmt, 3U, S32_TRACE_ARG(a), S32_TRACE_ARG(b), \
+			S32_TRACE_ARG(c), 0U)
+#define S32_TRACE_4(fmt, a, b, c, d) \
+	s32_trace_write(fmt, 4U, S32_TRACE_ARG(a), S32_TRACE_ARG(b), \
+			S32_TRACE_ARG(c), S32_TRACE_ARG(d))
+
+#define S32_TRACE_SELECT(_fmt, _1, _2, _3, _4, name, ...)	name
+#define S32_TRACE_N(...)						\
+	S32_TRACE_SELECT(__VA_ARGS__, S32_TRACE_4, S32_TRACE_3,	\
+			 S32_TRACE_2, S32_TRACE_1, S32_TRACE_0, 0)	\
+		(__VA_ARGS__)
+
+void s32_trace_write(const char *fmt, unsigned int nargs, u_register_t a0,
+		     u_register_t a1, u_register_t a2, u_register_t a3);
+
+#if S32_BL31_TRACE
+void s32_trace_init(uintptr_t base, size_t size);
+
+#define S32_TRACE(...)		S32_TRACE_N(__VA_ARGS__)
+#else
+static inline void s32_trace_init(uintptr_t base, size_t size)
+{
+}
+
+/* Keeps the arguments checked and used */
+#define S32_TRACE(...)					\
+	do {						\
+		if (false)				\
+			S32_TRACE_N(__VA_ARGS__);	\
+	} while (false)
+#endif /* S32_BL31_TRACE */
+
+#endif /* S32_TRACE_H */
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <lib/libc/errno.h>
+#include <drivers/auth/auth_offload.h>
+#include <platform.h>
+#include <s32_bl_common.h>
+#include "s32_mc_me.h"
+
+/* Second core of the boot cluster, which shares its L2 with the boot core */
+#define S32_AUTH_WORKER_CORE	1U
+
+void bl2_entrypoint(void);
+void __dead2 s32_bl2_auth_worker(void);
+
+/*
+ * The worker enters BL2 through the cold boot path and is diverted by
+ * plat_secondary_cold_boot_setup() to s32_bl2_auth_worker().
+ */
+int plat_auth_worker_start(void)
+{
+	/* The secondary cores are managed by the SCP */
+	if (is_scp_used())
+		return -ENOTSUP;
+
+	if (!is_a53_core_in_reset(S32_AUTH_WORKER_CORE))
+		return -EBUSY;
+
+	s32_set_core_entrypoint(S32_AUTH_WORKER_CORE,
+				(uintptr_t)bl2_entrypoint);
+	s32_kick_secondary_ca53_core(S32_AUTH_WORKER_CORE);
+
+	return 0;
+}
+
+/*
+ * BL31 expects the secondary cores to be held in reset. The worker cleans its
+ * caches and leaves the coherency in core_turn_off() before its first WFI, as
+ * it only waited for jobs with WFE: it is only reset once in WFI.
+ */
+void plat_auth_worker_stop(void)
+{
+	while (!is_a53_core_in_wfi(S32_AUTH_WORKER_CORE))
+		;
+
+	s32_turn_off_core(S32_MC_ME_CA53_PART, S32_AUTH_WORKER_CORE);
+}
+
+void __dead2 s32_bl2_auth_worker(void)
+{
+	auth_offload_worker();
+	core_turn_off();
+}
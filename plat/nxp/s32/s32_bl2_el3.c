@@ -49,6 +49,7 @@ void plat_ic_set_interrupt_pending(unsigned int id)
 #if (ERRATA_S32_050543 == 1)
 #include <dt-bindings/ddr-errata/s32-ddr-errata.h>
 #endif
+#include "s32_bootchart.h"
 #include "s32_dt.h"
 #include "s32_clocks.h"
 #include "s32_mc_me.h"
@@ -94,8 +95,15 @@ int add_bl31_img_to_mem_params_descs(bl_mem_params_node_t *params,
 					DISABLE_ALL_EXCEPTIONS),
 		.ep_info.pc = BL31_BASE,
 
+		/*
+		 * The post-load handling of BL31 is deferred until the next
+		 * image is loaded: it only marks the boot timeline, no other
+		 * image depends on it.
+		 */
 		SET_STATIC_PARAM_HEAD(image_info, PARAM_EP, VERSION_2,
-				      image_info_t, IMAGE_ATTRIB_PLAT_SETUP),
+				      image_info_t,
+				      IMAGE_ATTRIB_PLAT_SETUP |
+				      IMAGE_ATTRIB_ASYNC_AUTH),
 		.image_info.image_max_size = BL31_LIMIT - BL31_BASE,
 		.image_info.image_base = BL31_BASE,
 #ifdef SPD_opteed
@@ -183,7 +191,7 @@ int add_bl33_img_to_mem_params_descs(bl_mem_params_node_t *params,
 				      NON_SECURE | EXECUTABLE),
 
 		SET_STATIC_PARAM_HEAD(image_info, PARAM_EP, VERSION_2,
-				      image_info_t, 0),
+				      image_info_t, IMAGE_ATTRIB_ASYNC_AUTH),
 		.image_info.image_max_size = S32_BL33_IMAGE_SIZE,
 		.image_info.image_base = S32_BL33_IMAGE_BASE,
 		.next_handoff_image_id = INVALID_IMAGE_ID,
@@ -264,6 +272,10 @@ static mmap_region_t s32_mmap[] = {
 			MT_MEMORY | MT_RW, PAGE_SIZE),
 	MAP_REGION_FLAT(S32_PMEM_START, S32_PMEM_LEN,
 			MT_MEMORY | MT_RW | MT_SECURE),
+#if S32_LOGS_SIZE > 0
+	MAP_REGION_FLAT(S32_LOGS_BASE, S32_LOGS_SIZE,
+			MT_MEMORY | MT_RW | MT_NS),
+#endif
 	MAP_REGION_FLAT(S32_OSPM_SCMI_MEM,
 			MMU_ROUND_UP_TO_PAGE(S32_OSPM_SCMI_MEM_SIZE),
 			MT_NON_CACHEABLE | MT_RW | MT_SECURE),
@@ -318,7 +330,7 @@ static int disable_qspi_mmu_entry(void)
 		return -EFAULT;
 	}
 
-	offset = fdt_node_offset_by_compatible(fdt, -1, "nxp,s32cc-qspi");
+	offset = dt_node_offset_by_compatible(fdt, -1, "nxp,s32cc-qspi");
 	if (offset > 0) {
 		if (fdt_get_status(offset) == DT_ENABLED)
 			return 0;
@@ -495,6 +507,7 @@ struct bl_params *plat_get_next_bl_params(void)
 
 void plat_flush_next_bl_params(void)
 {
+	s32_bootchart_mark(S32_BOOT_BL2_EXIT, 0);
 	flush_bl_params_desc();
 }
 
@@ -507,12 +520,13 @@ static bool is_branch_op(uint32_t op)
 }
 
 #if S32CC_EMU == 0
-static int ft_fixup_exclude_ecc(void *blob)
+static int ft_fixup_exclude_ecc(const void *blob)
 {
 	int ret, nodeoff = -1;
 	bool found_first_node = false;
 	unsigned long start = 0, size = 0;
 	const char *node_name;
+	fdt64_t reg[2];
 
 	/* Get offset of memory node */
 	while ((nodeoff = fdt_node_offset_by_prop_value(blob, nodeoff,
@@ -532,24 +546,11 @@ static int ft_fixup_exclude_ecc(void *blob)
 
 		s32gen1_exclude_ecc(&start, &size);
 
-		/* Delete old "reg" property */
-		ret = fdt_delprop(blob, nodeoff, "reg");
+		/* Replace "reg" property with the newly-computed values */
+		reg[0] = cpu_to_fdt64(start);
+		reg[1] = cpu_to_fdt64(size);
+		ret = dt_fixup_setprop(nodeoff, "reg", reg, sizeof(reg));
 		if (ret) {
-			ERROR("Failed to remove 'reg' property of '%s' node\n",
-				node_name);
-			return ret;
-		}
-
-		/* Write newly-computed "reg" property values back to DT */
-		ret = fdt_setprop_u64(blob, nodeoff, "reg", start);
-		if (ret < 0) {
-			ERROR("Cannot write 'reg' property of '%s' node\n",
-				node_name);
-			return ret;
-		}
-
-		ret = fdt_appendprop_u64(blob, nodeoff, "reg", size);
-		if (ret < 0) {
 			ERROR("Cannot write 'reg' property of '%s' node\n",
 				node_name);
 			return ret;
@@ -565,20 +566,58 @@ static int ft_fixup_exclude_ecc(void *blob)
 }
 #endif
 
-static int ft_fixup_resmem_node(void *blob)
+static int ft_fixup_resmem_node(void)
 {
 	int ret;
 
-	ret = fdt_add_reserved_memory(blob, "atf", BL31_BASE, BL31_SIZE);
+	ret = dt_fixup_add_reserved_memory("atf", BL31_BASE, BL31_SIZE);
 	if (ret) {
 		ERROR("Failed to add 'atf' /reserved-memory node");
 		return ret;
 	}
 
+#if (S32_CONSOLE_RING == 1)
+	ret = dt_fixup_add_reserved_memory("tf-a-log", S32_CONSOLE_RING_BASE,
+					   S32_CONSOLE_RING_SIZE);
+	if (ret) {
+		ERROR("Failed to add 'tf-a-log' /reserved-memory node");
+		return ret;
+	}
+#endif
+
+#if (ENABLE_LOG_BUFFER == 1)
+	ret = dt_fixup_add_reserved_memory("tf-a-log-buffer",
+					   S32_LOG_BUFFER_BASE,
+					   S32_LOG_BUFFER_SIZE);
+	if (ret) {
+		ERROR("Failed to add 'tf-a-log-buffer' /reserved-memory node");
+		return ret;
+	}
+#endif
+
+#if (S32_BL31_TRACE == 1)
+	ret = dt_fixup_add_reserved_memory("tf-a-trace", S32_TRACE_BASE,
+					   S32_TRACE_SIZE);
+	if (ret) {
+		ERROR("Failed to add 'tf-a-trace' /reserved-memory node");
+		return ret;
+	}
+#endif
+
+#if (S32_BOOTCHART == 1)
+	ret = dt_fixup_add_reserved_memory("tf-a-bootchart",
+					   S32_BOOTCHART_BASE,
+					   S32_BOOTCHART_SIZE);
+	if (ret) {
+		ERROR("Failed to add 'tf-a-bootchart' /reserved-memory node");
+		return ret;
+	}
+#endif
+
 	return 0;
 }
 
-static int fdt_set_node_status(void *blob, int nodeoff, bool enable)
+static int fdt_set_node_status(int nodeoff, bool enable)
 {
 	const char *str;
 
@@ -587,16 +626,16 @@ static int fdt_set_node_status(void *blob, int nodeoff, bool enable)
 	else
 		str = "disabled";
 
-	return fdt_setprop_string(blob, nodeoff, "status", str);
+	return dt_fixup_setprop_string(nodeoff, "status", str);
 }
 
-static int disable_node_by_compatible(void *blob, const char *compatible,
+static int disable_node_by_compatible(const void *blob, const char *compatible,
 				      uint32_t *phandle)
 {
 	const char *node_name;
 	int nodeoff, ret;
 
-	nodeoff = fdt_node_offset_by_compatible(blob, -1, compatible);
+	nodeoff = dt_node_offset_by_compatible(blob, -1, compatible);
 	if (nodeoff < 0) {
 		ERROR("Failed to get a node based on compatible string '%s' (%s)\n",
 		      compatible, fdt_strerror(nodeoff));
@@ -611,14 +650,14 @@ static int disable_node_by_compatible(void *blob, const char *compatible,
 		return *phandle;
 	}
 
-	ret = fdt_set_node_status(blob, nodeoff, false);
+	ret = fdt_set_node_status(nodeoff, false);
 	if (ret) {
 		ERROR("Failed to disable '%s' node (%s)\n",
 		      node_name, fdt_strerror(ret));
 		return ret;
 	}
 
-	ret = fdt_delprop(blob, nodeoff, "phandle");
+	ret = dt_fixup_delprop(nodeoff, "phandle");
 	if (ret) {
 		ERROR("Failed to remove phandle property of '%s' node: %s\n",
 		       node_name, fdt_strerror(ret));
@@ -628,12 +667,12 @@ static int disable_node_by_compatible(void *blob, const char *compatible,
 	return 0;
 }
 
-static int set_scmi_protocol_node_status(void *blob, const char *path,
+static int set_scmi_protocol_node_status(const void *blob, const char *path,
 					 uint32_t phandle, bool enable)
 {
 	int nodeoff, ret;
 
-	nodeoff = fdt_path_offset(blob, path);
+	nodeoff = dt_path_offset(blob, path);
 	if (nodeoff < 0) {
 		ERROR("Failed to get offset of '%s' node (%s)\n",
 		      path, fdt_strerror(nodeoff));
@@ -641,7 +680,7 @@ static int set_scmi_protocol_node_status(void *blob, const char *path,
 	}
 
 	if (phandle) {
-		ret = fdt_setprop_u32(blob, nodeoff, "phandle", phandle);
+		ret = dt_fixup_setprop_u32(nodeoff, "phandle", phandle);
 		if (ret) {
 			ERROR("Failed to set phandle property of '%s' node (%s)\n",
 			      path, fdt_strerror(ret));
@@ -649,7 +688,7 @@ static int set_scmi_protocol_node_status(void *blob, const char *path,
 		}
 	}
 
-	ret = fdt_set_node_status(blob, nodeoff, enable);
+	ret = fdt_set_node_status(nodeoff, enable);
 	if (ret) {
 		ERROR("Failed to set status (%s) for node (%s)\n",
 		      fdt_strerror(ret), path);
@@ -659,28 +698,29 @@ static int set_scmi_protocol_node_status(void *blob, const char *path,
 	return 0;
 }
 
-static int enable_scmi_protocol(void *blob, const char *path, uint32_t phandle)
+static int enable_scmi_protocol(const void *blob, const char *path,
+				uint32_t phandle)
 {
 	return set_scmi_protocol_node_status(blob, path, phandle, true);
 }
 
-static int disable_siul2_gpio_node(void *blob, uint32_t *phandle)
+static int disable_siul2_gpio_node(const void *blob, uint32_t *phandle)
 {
 	return disable_node_by_compatible(blob, "nxp,s32cc-siul2-gpio",
 					  phandle);
 }
 
-static int enable_scmi_gpio_node(void *blob, uint32_t phandle)
+static int enable_scmi_gpio_node(const void *blob, uint32_t phandle)
 {
 	return enable_scmi_protocol(blob, gpio_scmi_node_path, phandle);
 }
 
-static int enable_scmi_nvmem_node(void *blob, uint32_t phandle)
+static int enable_scmi_nvmem_node(const void *blob, uint32_t phandle)
 {
 	return enable_scmi_protocol(blob, nvmem_scmi_node_path, phandle);
 }
 
-static int ft_fixup_gpio(void *blob)
+static int ft_fixup_gpio(const void *blob)
 {
 	uint32_t phandle;
 	int ret;
@@ -696,13 +736,13 @@ static int ft_fixup_gpio(void *blob)
 	return 0;
 }
 
-static int find_nvmem_scmi_node(void *blob, int *nodeoff,
+static int find_nvmem_scmi_node(const void *blob, int *nodeoff,
 				const fdt32_t **phandles)
 {
 	int scmi_nvmem_nodeoff;
 	const fdt32_t *scmi_nvmem_phandles;
 
-	scmi_nvmem_nodeoff = fdt_path_offset(blob, nvmem_scmi_node_path);
+	scmi_nvmem_nodeoff = dt_path_offset(blob, nvmem_scmi_node_path);
 	if (scmi_nvmem_nodeoff < 0) {
 		ERROR("Failed to get NVMEM SCMI node with path '%s' (%s)\n",
 		      nvmem_scmi_node_path, fdt_strerror(scmi_nvmem_nodeoff));
@@ -723,8 +763,8 @@ static int find_nvmem_scmi_node(void *blob, int *nodeoff,
 	return 0;
 }
 
-static int find_nvmem_consumer_node(void *blob, int nodeoff_scmi, int *nodeoff,
-				    int *num_phandles)
+static int find_nvmem_consumer_node(const void *blob, int nodeoff_scmi,
+				    int *nodeoff, int *num_phandles)
 {
 	int count;
 	int startoffset = *nodeoff;
@@ -761,7 +801,8 @@ static int find_nvmem_consumer_node(void *blob, int nodeoff_scmi, int *nodeoff,
 	return 0;
 }
 
-static int update_nvmem_consumer_phandles(void *blob, int nodeoff_consumer,
+static int update_nvmem_consumer_phandles(const void *blob,
+					  int nodeoff_consumer,
 					  int num_phandles, int nodeoff_scmi,
 					  const fdt32_t *phandles_scmi)
 {
@@ -794,9 +835,8 @@ static int update_nvmem_consumer_phandles(void *blob, int nodeoff_consumer,
 		new_phandles[i] = phandles_scmi[idx];
 	}
 
-	ret = fdt_setprop_inplace(blob, nodeoff_consumer, "nvmem-cells",
-				  new_phandles,
-				  num_phandles * sizeof(uint32_t));
+	ret = dt_fixup_setprop(nodeoff_consumer, "nvmem-cells", new_phandles,
+			       num_phandles * sizeof(uint32_t));
 	if (ret) {
 		ERROR("Failed to set 'nvmem-cells' property of '%s' node (%s)\n",
 		      fdt_get_name(blob, nodeoff_consumer, NULL),
@@ -807,7 +847,7 @@ static int update_nvmem_consumer_phandles(void *blob, int nodeoff_consumer,
 	return 0;
 }
 
-static int ft_fixup_nvmem(void *blob)
+static int ft_fixup_nvmem(const void *blob)
 {
 	int nodeoff_scmi, nodeoff_consumer;
 	int num_phandles, ret;
@@ -843,39 +883,54 @@ static int ft_fixup_nvmem(void *blob)
 	return enable_scmi_nvmem_node(blob, 0);
 }
 
-static int ft_fixups(void *blob)
+/*
+ * The fixups are collected against the DTB of BL2, which is left untouched,
+ * and written along with it to 'blob' in one go.
+ */
+static int ft_fixups(const void *src, void *blob)
 {
-	size_t size = fdt_totalsize(blob);
+	size_t size;
 	int ret;
 
-	size += S32_FDT_UPDATES_SPACE;
-	fdt_set_totalsize(blob, size);
+	dt_fixup_init(src);
 
 #if S32CC_EMU == 0
-	ret = ft_fixup_exclude_ecc(blob);
+	ret = ft_fixup_exclude_ecc(src);
 	if (ret)
-		goto out;
+		return ret;
 #endif /* S32CC_EMU */
 
-	ret = ft_fixup_resmem_node(blob);
+	ret = ft_fixup_resmem_node();
 	if (ret)
-		goto out;
+		return ret;
 
 	if (is_scp_used() && is_gpio_scmi_fixup_enabled()) {
-		ret = ft_fixup_gpio(blob);
+		ret = ft_fixup_gpio(src);
 		if (ret)
-			goto out;
+			return ret;
 	}
 
 	if (is_scp_used() && is_nvmem_scmi_fixup_enabled()) {
-		ret = ft_fixup_nvmem(blob);
+		ret = ft_fixup_nvmem(src);
 		if (ret)
-			goto out;
+			return ret;
+	}
+
+	ret = dt_fixup_apply(blob, BL33_MAX_DTB_SIZE);
+	if (ret) {
+		ERROR("Failed to write the DTB of BL33 (%s)\n",
+		      fdt_strerror(ret));
+		return ret;
 	}
 
-out:
-	flush_dcache_range((uintptr_t)blob, size);
-	return ret;
+	/* Leave some room for the fixups of BL33 */
+	size = fdt_totalsize(blob) + S32_FDT_UPDATES_SPACE;
+	if (size <= BL33_MAX_DTB_SIZE)
+		fdt_set_totalsize(blob, size);
+
+	flush_dcache_range((uintptr_t)blob, fdt_totalsize(blob));
+
+	return 0;
 }
 
 /* Computes the size of the images inside FIP and updates image io_block spec.
@@ -925,6 +980,8 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 	bl_mem_params_node_t *pager_mem_params = NULL;
 	bl_mem_params_node_t *paged_mem_params = NULL;
 
+	s32_bootchart_mark(S32_BOOT_IMAGE_READY, image_id);
+
 	if (image_id == BL33_IMAGE_ID) {
 		magic = mmio_read_32(BL33_ENTRYPOINT);
 		if (!is_branch_op(magic)) {
@@ -939,12 +996,12 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 			return -EIO;
 		}
 
-		memcpy((void *)BL33_DTB, (void *)get_bl2_dtb_base(),
-		       get_bl2_dtb_size());
-
-		ret = ft_fixups((void *)BL33_DTB);
+		s32_bootchart_mark(S32_BOOT_DT_FIXUPS, 0);
+		ret = ft_fixups((const void *)get_bl2_dtb_base(),
+				(void *)BL33_DTB);
 		if (ret)
 			return ret;
+		s32_bootchart_mark(S32_BOOT_DT_READY, 0);
 	}
 
 	if (image_id == BL32_IMAGE_ID) {
@@ -14,6 +14,7 @@
 
 #include "platform_def.h"
 #include "s32_bl_common.h"
+#include "s32_bootchart.h"
 #include "s32_clocks.h"
 #include "s32_dt.h"
 #include "s32_linflexuart.h"
@@ -24,6 +25,7 @@
 #include "s32_sramc.h"
 #include "s32_interrupt_mgmt.h"
 #include "s32_scp_scmi.h"
+#include "s32_trace.h"
 
 #define MMU_ROUND_UP_TO_4K(x)	\
 	(((x) & ~0xfffU) == (x) ? (x) : ((x) & ~0xfffU) + 0x1000U)
@@ -36,6 +38,20 @@ IMPORT_SYM(uintptr_t, __RW_START__, BL31_RW_START);
 static gicv3_redist_ctx_t rdisif_ctxs[PLATFORM_CORE_COUNT];
 static gicv3_dist_ctx_t dist_ctx;
 
+/*
+ * Redistributor state of each core:
+ *  - 'dirty': the core has been online since its context was last saved,
+ *  - 'saved': rdisif_ctxs[] holds a context of the core,
+ *  - 'restore': the context is restored when the core comes online.
+ * A redistributor whose core stayed off keeps the context saved earlier, or
+ * its reset state if the core has never been online.
+ */
+static struct {
+	bool dirty;
+	bool saved;
+	bool restore;
+} rdisif_state[PLATFORM_CORE_COUNT];
+
 static const mmap_region_t s32_mmap[] = {
 	MAP_REGION_FLAT(S32_UART_BASE, S32_UART_SIZE,
 			MT_DEVICE | MT_RW | MT_NS),
@@ -97,6 +113,10 @@ static const mmap_region_t s32_mmap[] = {
 			MT_MEMORY | MT_RW, PAGE_SIZE),
 	MAP_REGION_FLAT(S32_PMEM_START, S32_PMEM_LEN,
 			MT_MEMORY | MT_RW | MT_SECURE),
+#if S32_LOGS_SIZE > 0
+	MAP_REGION_FLAT(S32_LOGS_BASE, S32_LOGS_SIZE,
+			MT_MEMORY | MT_RW | MT_NS),
+#endif
 	MAP_REGION_FLAT(S32_OSPM_SCMI_MEM,
 			MMU_ROUND_UP_TO_PAGE(S32_OSPM_SCMI_MEM_SIZE),
 			MT_NON_CACHEABLE | MT_RW | MT_SECURE),
@@ -166,110 +186,159 @@ static gicv3_driver_data_t s32_gic_data = {
 	.mpidr_to_core_pos = plat_s32_mpidr_to_core_pos,
 };
 
-volatile uint32_t s32_core_release_var[PLATFORM_CORE_COUNT];
-DEFINE_BAKERY_LOCK(s32_core_state_lock);
+/*
+ * Core state flags, kept in three cache lines per core:
+ *  - 'release' holds CPU_ON and CPU_USE_WFI_FOR_SLEEP. It is
+ *    written by the core itself, or by the core turning it on once PSCI
+ *    reports it as off.
+ *  - 'cpuif' holds CPUIF_EN. It is written by the core itself, or by the last
+ *    core going into system suspend.
+ *  - 'cluster' holds the CLUSTER_PWRDN flags. It is only written by the core
+ *    itself.
+ *
+ * Each word has a single writer at any time, so no lock is needed. Cores which
+ * are powering down run with the data cache disabled and access memory
+ * directly, therefore a core with the data cache enabled cleans and
+ * invalidates the line around each access.
+ */
+typedef struct s32_core_state {
+	volatile uint32_t release __aligned(CACHE_WRITEBACK_GRANULE);
+	volatile uint32_t cpuif __aligned(CACHE_WRITEBACK_GRANULE);
+	volatile uint32_t cluster __aligned(CACHE_WRITEBACK_GRANULE);
+} s32_core_state_t;
+
+static s32_core_state_t s32_core_state[PLATFORM_CORE_COUNT];
+
+#define RELEASE_FLAGS	(CPU_ON | CPU_USE_WFI_FOR_SLEEP)
+#define CPUIF_FLAGS	(CPUIF_EN)
+#define CLUSTER_FLAGS	(CLUSTER_PWRDN(0) | CLUSTER_PWRDN(1))
+
+static uint32_t read_state(volatile uint32_t *word)
+{
+	if (is_dcache_enabled()) {
+		flush_dcache_range((uintptr_t)word, sizeof(*word));
+	}
+
+	return *word;
+}
+
+static void write_state(volatile uint32_t *word, uint32_t mask, uint32_t flag)
+{
+	*word = (read_state(word) & ~mask) | flag;
+
+	if (is_dcache_enabled()) {
+		flush_dcache_range((uintptr_t)word, sizeof(*word));
+	}
+}
 
 void update_core_state(uint32_t core, uint32_t mask, uint32_t flag)
 {
-	bakery_lock_get(&s32_core_state_lock);
-	inv_dcache_range((uintptr_t)s32_core_release_var,
-			 sizeof(s32_core_release_var));
-	s32_core_release_var[core] &= ~mask;
-	s32_core_release_var[core] |= flag;
-	flush_dcache_range((uintptr_t)&s32_core_release_var[core],
-			   sizeof(s32_core_release_var[core]));
-	bakery_lock_release(&s32_core_state_lock);
+	s32_core_state_t *state = &s32_core_state[core];
+
+	assert(core < PLATFORM_CORE_COUNT);
+	assert((flag & ~mask) == 0U);
+
+	if ((mask & RELEASE_FLAGS) != 0U) {
+		write_state(&state->release, mask & RELEASE_FLAGS,
+			    flag & RELEASE_FLAGS);
+	}
+
+	if ((mask & CPUIF_FLAGS) != 0U) {
+		write_state(&state->cpuif, mask & CPUIF_FLAGS,
+			    flag & CPUIF_FLAGS);
+	}
+
+	if ((mask & CLUSTER_FLAGS) != 0U) {
+		write_state(&state->cluster, mask & CLUSTER_FLAGS,
+			    flag & CLUSTER_FLAGS);
+	}
 }
 
 uint32_t get_core_state(uint32_t core, uint32_t mask)
 {
-	uint32_t status;
+	s32_core_state_t *state = &s32_core_state[core];
+	uint32_t status = 0U;
 
-	bakery_lock_get(&s32_core_state_lock);
-	inv_dcache_range((uintptr_t)s32_core_release_var,
-			 sizeof(s32_core_release_var));
-	status = s32_core_release_var[core] & mask;
-	bakery_lock_release(&s32_core_state_lock);
+	assert(core < PLATFORM_CORE_COUNT);
 
-	return status;
+	if ((mask & RELEASE_FLAGS) != 0U) {
+		status |= read_state(&state->release);
+	}
+
+	if ((mask & CPUIF_FLAGS) != 0U) {
+		status |= read_state(&state->cpuif);
+	}
+
+	if ((mask & CLUSTER_FLAGS) != 0U) {
+		status |= read_state(&state->cluster);
+	}
+
+	return status & mask;
 }
 
-/**
- * The caller must take 's32_core_state_lock'
- * and invalidate the caches on 's32_core_release_var'.
- */
 static bool is_cpu_on(uint32_t core)
 {
-	return !!(s32_core_release_var[core] & CPU_ON);
+	return (read_state(&s32_core_state[core].release) & CPU_ON) != 0U;
 }
 
 bool is_core_enabled(uint32_t core)
 {
-	bool status;
-
-	bakery_lock_get(&s32_core_state_lock);
-	inv_dcache_range((uintptr_t)s32_core_release_var,
-			 sizeof(s32_core_release_var));
-	status = is_cpu_on(core);
-	bakery_lock_release(&s32_core_state_lock);
-
-	return status;
+	return is_cpu_on(core);
 }
 
-bool is_last_core(void)
+static bool is_cluster_off(unsigned int first_core)
 {
-	size_t i, on = 0U;
+	unsigned int i;
 
-	bakery_lock_get(&s32_core_state_lock);
-	inv_dcache_range((uintptr_t)s32_core_release_var,
-			 sizeof(s32_core_release_var));
-	for (i = 0U; i < ARRAY_SIZE(s32_core_release_var); i++) {
+	for (i = first_core; i < first_core + PLATFORM_CORE_COUNT / 2; i++) {
 		if (is_cpu_on(i))
-			on++;
+			return false;
 	}
-	bakery_lock_release(&s32_core_state_lock);
 
-	return (on == 1);
+	return true;
 }
 
 bool is_cluster0_off(void)
 {
-	size_t i;
-	bool off_status = true;
+	return is_cluster_off(0U);
+}
 
-	bakery_lock_get(&s32_core_state_lock);
-	inv_dcache_range((uintptr_t)s32_core_release_var,
-			 sizeof(s32_core_release_var));
-	for (i = 0U; i < PLATFORM_CORE_COUNT / 2; i++) {
-		if (is_cpu_on(i))
-			off_status = false;
+bool is_cluster1_off(void)
+{
+	return is_cluster_off(PLATFORM_CORE_COUNT / 2);
+}
 
-		if (!off_status)
-			break;
+/* Whether no core of the cluster other than the caller is on */
+bool is_cluster_idle(unsigned int cluster)
+{
+	unsigned int i, pos = plat_my_core_pos();
+	unsigned int first = cluster * (PLATFORM_CORE_COUNT / 2);
+	uint32_t state;
+
+	for (i = first; i < first + PLATFORM_CORE_COUNT / 2; i++) {
+		if (i == pos)
+			continue;
+
+		state = read_state(&s32_core_state[i].release);
+		if ((state & CPU_ON) != 0U)
+			return false;
 	}
-	bakery_lock_release(&s32_core_state_lock);
 
-	return off_status;
+	return true;
 }
 
-bool is_cluster1_off(void)
+/* Whether a core is taking the cluster out of the coherency domain */
+bool is_cluster_pwrdn(unsigned int cluster)
 {
-	size_t i;
-	bool off_status = true;
-
-	bakery_lock_get(&s32_core_state_lock);
-	inv_dcache_range((uintptr_t)s32_core_release_var,
-			 sizeof(s32_core_release_var));
-	for (i = PLATFORM_CORE_COUNT / 2; i < PLATFORM_CORE_COUNT; i++) {
+	unsigned int i;
 
-		if (is_cpu_on(i)) {
-			off_status = false;
-			break;
-		}
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		if ((read_state(&s32_core_state[i].cluster) &
+		     CLUSTER_PWRDN(cluster)) != 0U)
+			return true;
 	}
-	bakery_lock_release(&s32_core_state_lock);
 
-	return off_status;
+	return false;
 }
 
 static uint32_t s32_get_spsr_for_bl33_entry(void)
@@ -447,8 +516,8 @@ static interrupt_prop_t *register_hse_irqs(interrupt_prop_t *itr,
 	}
 
 	while (true) {
-		offs = fdt_node_offset_by_compatible(fdt, offs,
-						     "nxp,s32cc-hse");
+		offs = dt_node_offset_by_compatible(fdt, offs,
+						    "nxp,s32cc-hse");
 
 		if (offs == -FDT_ERR_NOTFOUND)
 			break;
@@ -532,6 +601,7 @@ void s32_gic_setup(void)
 	gicv3_rdistif_init(pos);
 	gicv3_cpuif_enable(pos);
 	update_core_state(pos, CPUIF_EN, CPUIF_EN);
+	rdisif_state[pos].dirty = true;
 }
 
 void plat_gic_save(void)
@@ -546,18 +616,47 @@ void plat_gic_save(void)
 	}
 
 	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		if (!rdisif_state[i].dirty)
+			continue;
+
 		gicv3_rdistif_save(i, &rdisif_ctxs[i]);
+		rdisif_state[i].dirty = false;
+		rdisif_state[i].saved = true;
 	}
 
 	gicv3_distif_save(&dist_ctx);
 }
 
+/*
+ * Restore the distributor and the redistributor of the resuming core. The
+ * other cores are off at this point, their redistributors are restored by
+ * plat_gic_rdistif_online() if and when they are turned on.
+ */
 void plat_gic_restore(void)
 {
+	unsigned int i;
+
 	gicv3_distif_init_restore(&dist_ctx);
 
-	for (int i = 0; i < PLATFORM_CORE_COUNT; i++)
-		gicv3_rdistif_init_restore(i, &rdisif_ctxs[i]);
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		rdisif_state[i].restore = rdisif_state[i].saved;
+
+	plat_gic_rdistif_online(plat_my_core_pos());
+}
+
+/*
+ * Called for a core coming online, before its redistributor is set up by
+ * gicv3_rdistif_init(): restore its redistributor if this was deferred, and
+ * save it again on the next suspend.
+ */
+void plat_gic_rdistif_online(unsigned int core)
+{
+	if (rdisif_state[core].restore) {
+		gicv3_rdistif_init_restore(core, &rdisif_ctxs[core]);
+		rdisif_state[core].restore = false;
+	}
+
+	rdisif_state[core].dirty = true;
 }
 
 void bl31_plat_arch_setup(void)
@@ -565,6 +664,15 @@ void bl31_plat_arch_setup(void)
 	s32_smp_fixup();
 	s32_el3_mmu_fixup();
 
+	if (tf_log_buffer_init(S32_LOG_BUFFER_BASE, S32_LOG_BUFFER_SIZE,
+			       false))
+		ERROR("Failed to set up the log buffer\n");
+
+	s32_trace_init(S32_TRACE_BASE, S32_TRACE_SIZE);
+
+	if (s32_bootchart_init(S32_BOOTCHART_BASE, S32_BOOTCHART_SIZE))
+		VERBOSE("No boot timeline from BL2\n");
+
 #if (S32_USE_LINFLEX_IN_BL31 == 1)
 	console_s32_register();
 #endif
@@ -584,6 +692,12 @@ void bl31_plat_runtime_setup(void)
 {
 	int rx_irq_num = scp_get_rx_plat_irq();
 
+	s32_bootchart_mark(S32_BOOT_BL31_EXIT, 0);
+	s32_bootchart_print();
+
+	/* The other cores may print from now on */
+	console_s32_ring_stop();
+
 	if (is_scp_used()) {
 		s32cc_el3_interrupt_config();
 
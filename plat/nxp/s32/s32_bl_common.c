@@ -4,13 +4,16 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #include <arch/aarch64/arch.h>
+#include <arch_helpers.h>
 #include <common/debug.h>
+#include <drivers/delay_timer.h>
 #include <drivers/generic_delay_timer.h>
 #include "ddr_lp.h"
 #include "ddr_utils.h"
 #include <libfdt.h>
 #include <lib/mmio.h>
 #include <inttypes.h>
+#include <plat/common/platform.h>
 #include "platform_def.h"
 #include "s32_bl_common.h"
 #include "s32_clocks.h"
@@ -19,6 +22,8 @@
 #include "s32_ddr_errata_funcs.h"
 #endif
 #include "s32_dt.h"
+#include "s32_dt_config.h"
+#include "s32_linflexuart.h"
 #include "s32_lowlevel.h"
 #include "s32_ncore.h"
 #include "s32_pinctrl.h"
@@ -126,7 +131,40 @@ void s32_early_plat_init(void)
 	ncore_init();
 	ncore_caiu_online(A53_CLUSTER0_CAIU);
 
+	s32_delay_timer_init();
+}
+
+#if (S32_CONSOLE_RING == 1)
+/* The delays are idle points, at which the console ring is drained */
+static uint32_t s32_get_timer_value(void)
+{
+	console_s32_drain();
+
+	/* Down counter, as in generic_delay_timer.c */
+	return (uint32_t)(~read_cntpct_el0());
+}
+#endif
+
+void s32_delay_timer_init(void)
+{
+#if (S32_CONSOLE_RING == 1)
+	static timer_ops_t ops;
+	unsigned int mult = MHZ_TICKS_PER_SEC;
+	unsigned int div = plat_get_syscnt_freq2();
+
+	while (((mult % 10U) == 0U) && ((div % 10U) == 0U)) {
+		mult /= 10U;
+		div /= 10U;
+	}
+
+	ops.get_timer_value = s32_get_timer_value;
+	ops.clk_mult = mult;
+	ops.clk_div = div;
+
+	timer_init(&ops);
+#else
 	generic_delay_timer_init();
+#endif
 }
 
 void plat_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
@@ -146,6 +184,7 @@ unsigned int plat_get_syscnt_freq2(void)
 
 struct s32_i2c_driver *s32_add_i2c_module(void *fdt, int fdt_node)
 {
+	const struct s32_dt_i2c_config *static_i2c;
 	struct s32_i2c_driver *driver;
 	struct dt_node_info i2c_info;
 	size_t i;
@@ -175,7 +214,14 @@ struct s32_i2c_driver *s32_add_i2c_module(void *fdt, int fdt_node)
 	}
 
 	driver->fdt_node = fdt_node;
-	s32_i2c_get_setup_from_fdt(fdt, fdt_node, &driver->bus);
+
+	static_i2c = dt_get_static_i2c(fdt_node);
+	if (static_i2c) {
+		driver->bus.base = static_i2c->base;
+		driver->bus.speed = static_i2c->speed;
+	} else {
+		s32_i2c_get_setup_from_fdt(fdt, fdt_node, &driver->bus);
+	}
 
 	i2c_fill_level++;
 	return driver;
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <drivers/nxp/s32/stm/s32_stm.h>
+#include <lib/libc/errno.h>
+#include <plat/common/platform.h>
+#include <platform_def.h>
+#include <s32_bl_common.h>
+#include <s32_bootchart.h>
+#include <string.h>
+
+/* Milestones of BL2 before the DDR is initialized */
+#define EARLY_ENTRIES		16U
+
+static const char *const milestone_names[] = {
+	[S32_BOOT_BL2] = "bl2",
+	[S32_BOOT_STORAGE] = "storage",
+	[S32_BOOT_PMIC] = "pmic",
+	[S32_BOOT_SRAM] = "sram",
+	[S32_BOOT_DDR_TRAINING] = "ddr-training",
+	[S32_BOOT_DDR_TRAINED] = "ddr-trained",
+	[S32_BOOT_DDR] = "ddr",
+	[S32_BOOT_IMAGE_LOAD] = "image-load",
+	[S32_BOOT_IMAGE_READY] = "image-ready",
+	[S32_BOOT_DT_FIXUPS] = "dt-fixups",
+	[S32_BOOT_DT_READY] = "dt-ready",
+	[S32_BOOT_BL2_EXIT] = "bl2-exit",
+	[S32_BOOT_BL31] = "bl31",
+	[S32_BOOT_BL31_EXIT] = "bl31-exit",
+};
+
+CASSERT(ARRAY_SIZE(milestone_names) == S32_BOOT_MILESTONES,
+	assert_s32_bootchart_names);
+
+static struct s32_stm stm = {
+	.base = STM6_BASE_ADDR,
+};
+
+static struct s32_bootchart *chart;
+
+#if defined(IMAGE_BL2)
+static struct {
+	struct s32_bootchart hdr;
+	struct s32_bootchart_entry entries[EARLY_ENTRIES];
+} early;
+
+/* Called by BL2 once the clocks are set up */
+void s32_bootchart_start(void)
+{
+	if (!s32_stm_is_enabled(&stm)) {
+		/* The SCP owns the timer */
+		if (is_scp_used()) {
+			WARN("STM6 is stopped, no boot timeline\n");
+			return;
+		}
+
+		s32_stm_enable(&stm, true);
+	}
+
+	early.hdr.magic = S32_BOOTCHART_MAGIC;
+	early.hdr.version = S32_BOOTCHART_VERSION;
+	early.hdr.max_entries = EARLY_ENTRIES;
+	early.hdr.syscnt_freq = plat_get_syscnt_freq2();
+	chart = &early.hdr;
+
+	s32_bootchart_mark(S32_BOOT_BL2, 0);
+}
+
+/* Moves the early milestones to the region passed to the normal world */
+int s32_bootchart_init(uintptr_t base, size_t size)
+{
+	struct s32_bootchart *dst = (struct s32_bootchart *)base;
+	size_t len;
+
+	if (chart == NULL)
+		return -ENODEV;
+
+	if (size < sizeof(early))
+		return -ENOMEM;
+
+	len = sizeof(*chart) + (chart->n_entries * sizeof(chart->entries[0]));
+	(void)memcpy(dst, chart, len);
+	dst->max_entries = (size - sizeof(*dst)) / sizeof(dst->entries[0]);
+	flush_dcache_range(base, len);
+
+	chart = dst;
+
+	return 0;
+}
+#else
+/* Continues the timeline of BL2, if any */
+int s32_bootchart_init(uintptr_t base, size_t size)
+{
+	struct s32_bootchart *hdr = (struct s32_bootchart *)base;
+
+	if ((size < sizeof(*hdr)) || (hdr->magic != S32_BOOTCHART_MAGIC) ||
+	    (hdr->version != S32_BOOTCHART_VERSION) ||
+	    (hdr->max_entries > ((size - sizeof(*hdr)) /
+				 sizeof(hdr->entries[0]))) ||
+	    (hdr->n_entries > hdr->max_entries))
+		return -ENOENT;
+
+	chart = hdr;
+	s32_bootchart_mark(S32_BOOT_BL31, 0);
+
+	return 0;
+}
+#endif /* IMAGE_BL2 */
+
+/*
+ * Only called on the boot core. The entries are flushed as they are written,
+ * BL2 and BL31 turn their MMU off in between.
+ */
+void s32_bootchart_mark(enum s32_boot_milestone milestone, unsigned int arg)
+{
+	struct s32_bootchart_entry *entry;
+
+	if ((chart == NULL) || (chart->n_entries >= chart->max_entries))
+		return;
+
+	entry = &chart->entries[chart->n_entries];
+	entry->milestone = (uint16_t)milestone;
+	entry->arg = (uint16_t)arg;
+	entry->stm = s32_stm_get_count(&stm);
+	entry->syscnt = read_cntpct_el0();
+
+	chart->n_entries++;
+
+	if (is_dcache_enabled()) {
+		flush_dcache_range((uintptr_t)entry, sizeof(*entry));
+		flush_dcache_range((uintptr_t)&chart->n_entries,
+				   sizeof(chart->n_entries));
+	}
+}
+
+static unsigned long long to_us(uint64_t ticks)
+{
+	return (unsigned long long)(ticks * 1000000U / chart->syscnt_freq);
+}
+
+void s32_bootchart_print(void)
+{
+	const struct s32_bootchart_entry *entry;
+	uint64_t prev = 0;
+	unsigned int i;
+
+	if ((chart == NULL) || (chart->syscnt_freq == 0U))
+		return;
+
+	for (i = 0; i < chart->n_entries; i++) {
+		entry = &chart->entries[i];
+		if (entry->milestone >= S32_BOOT_MILESTONES)
+			continue;
+
+		INFO("Boot: %s(%u) at %llu us (+%llu us)\n",
+		     milestone_names[entry->milestone], entry->arg,
+		     to_us(entry->syscnt), to_us(entry->syscnt - prev));
+		prev = entry->syscnt;
+	}
+}
@@ -5,7 +5,6 @@
 #
 
 include drivers/arm/gic/v3/gicv3.mk
-include lib/libc/libc.mk
 include lib/libfdt/libfdt.mk
 include lib/xlat_tables_v2/xlat_tables.mk
 include make_helpers/build_macros.mk
@@ -17,6 +16,15 @@ ERRATA_A53_1530924	:= 1
 ERRATA_SPECULATIVE_AT	:= 1
 ERRATA_S32_051700	:= 1
 
+# Use libc_asm, with the AArch64 memcpy, memmove and memcmp in place of the C
+# versions it keeps for the other platforms
+OVERRIDE_LIBC		:= 1
+include lib/libc/libc_asm.mk
+LIBC_SRCS		:= $(filter-out $(addprefix lib/libc/,		\
+				memcmp.c memcpy.c memmove.c), ${LIBC_SRCS})	\
+			   $(addprefix lib/libc/aarch64/,		\
+				memcmp.S memcpy.S memmove.S)
+
 # Tools
 AWK ?= gawk
 HEXDUMP ?= xxd
@@ -82,6 +90,7 @@ PLAT_BL_COMMON_SOURCES += \
 			drivers/nxp/uart/linflexuart.c \
 			${S32_PLAT}/s32_bl_common.c \
 			${S32_PLAT}/s32_dt.c \
+			${S32_PLAT}/s32_dt_index.c \
 			${S32_PLAT}/s32_lowlevel_common.S \
 			${S32_PLAT}/s32_sramc.c \
 			${S32_PLAT}/s32_sramc_asm.S \
@@ -126,12 +135,19 @@ BL2_SOURCES += \
 			${S32_DRIVERS}/scmi_logger/s32_scmi_logger.c \
 			lib/optee/optee_utils.c \
 			${S32_PLAT}/s32_bl2_el3.c \
+			${S32_PLAT}/s32_dt_fixup.c \
 			${S32_PLAT}/s32_storage.c \
 			${S32_PLAT}/s32_lowlevel_bl2.S \
 			${S32_PLAT}/s32_scp_utils.c \
 			${S32_PLAT}/s32_scp_scmi.c \
 			drivers/arm/css/scmi/scmi_common.c \
 
+ifeq (${PARALLEL_IMAGE_AUTH},1)
+BL2_SOURCES += \
+			${S32_PLAT}/s32_bl2_auth.c \
+
+endif
+
 BL31_SOURCES += \
 			${XLAT_TABLES_LIB_SRCS} \
 			drivers/scmi-msg/base.c \
@@ -223,6 +239,29 @@ LOG_LEVEL		?= 50
 S32_USE_LINFLEX_IN_BL31	?= 0
 $(eval $(call add_define_val,S32_USE_LINFLEX_IN_BL31,$(S32_USE_LINFLEX_IN_BL31)))
 
+# Write the console to a ring in DDR, drained to the UART in the background,
+# instead of waiting for the UART on each character. The ring is passed to
+# Linux as the 'tf-a-log' reserved memory region.
+S32_CONSOLE_RING	?= 0
+$(eval $(call add_define_val,S32_CONSOLE_RING,$(S32_CONSOLE_RING)))
+
+# Binary trace of the BL31 runtime paths, see s32_trace.h. It is decoded by
+# tools/nxp/s32_trace, from the ELF of BL31.
+S32_BL31_TRACE		?= 0
+$(eval $(call add_define_val,S32_BL31_TRACE,$(S32_BL31_TRACE)))
+ifeq (${S32_BL31_TRACE},1)
+BL31_SOURCES		+= ${S32_PLAT}/s32_trace.c
+endif
+
+# Timeline of the cold boot, see s32_bootchart.h. It is passed to Linux as the
+# 'tf-a-bootchart' reserved memory region.
+S32_BOOTCHART		?= 0
+$(eval $(call add_define_val,S32_BOOTCHART,$(S32_BOOTCHART)))
+ifeq (${S32_BOOTCHART},1)
+BL2_SOURCES		+= ${S32_PLAT}/s32_bootchart.c
+BL31_SOURCES		+= ${S32_PLAT}/s32_bootchart.c
+endif
+
 # Whether we're going to run a hypervisor (EL2) or jump straight into the
 # bootloader (EL1)
 S32_HAS_HV		?= 0
@@ -234,6 +273,24 @@ $(eval $(call add_define_val,S32_HAS_HV,$(S32_HAS_HV)))
 S32_SET_NEAREST_FREQ	?= 0
 $(eval $(call add_define_val,S32_SET_NEAREST_FREQ,$(S32_SET_NEAREST_FREQ)))
 
+# Extract the static board configuration from the DTB at build time (SCP
+# mailboxes and interrupts, I2C buses) into const tables, instead of parsing
+# it at runtime. The DTB is still parsed if it is not the one of the build.
+S32_DT_STATIC_CONFIG	?= 0
+$(eval $(call add_define_val,S32_DT_STATIC_CONFIG,$(S32_DT_STATIC_CONFIG)))
+
+# PSCI_STAT_RESIDENCY and PSCI_STAT_COUNT. The residencies are measured with
+# PMF timestamps of the generic timer, so PMF is enabled along with them.
+ifeq (${ENABLE_PSCI_STAT},1)
+ENABLE_PMF		:= 1
+endif
+
+# The PMF timestamps of the S32 PSCI paths (see s32_pmf.h) and of PSCI_STAT
+# are read through the SiP service, using PMF_SMC_GET_TIMESTAMP_{32,64}.
+ifeq (${ENABLE_PMF},1)
+BL31_SOURCES		+= lib/pmf/pmf_smc.c
+endif
+
 ifeq (${SECBOOT_SUPPORT},1)
 ifeq (${RSA_PRIV_FIP},)
 $(error RSA_PRIV_FIP is not set)
@@ -449,6 +506,28 @@ ${BOOT_INFO_SRC}: ${FIP_MMC_OFFSET_FILE} ${FIP_EMMC_OFFSET_FILE} ${FIP_QSPI_OFFS
 	${Q}echo "const unsigned int fip_hdr_size = $$(cat ${FIP_HDR_SIZE_FILE});" >> ${BOOT_INFO_SRC}
 	${Q}echo "const unsigned int dtb_size = $$(cat ${DTB_SIZE_FILE});" >> ${BOOT_INFO_SRC}
 
+ifeq (${S32_DT_STATIC_CONFIG},1)
+S32_DT2C_PATH		:= tools/nxp/s32_dt2c
+S32_DT2C		:= ${S32_DT2C_PATH}/s32_dt2c${BIN_EXT}
+S32_DT_CONFIG_SRC	:= ${BUILD_PLAT}/s32_dt_static_config.c
+
+PLAT_BL_COMMON_SOURCES	+= \
+			${S32_PLAT}/s32_dt_config.c \
+			${S32_DT_CONFIG_SRC} \
+
+${S32_DT2C}: ${S32_DT2C_PATH}/s32_dt2c.c
+	${Q}${MAKE} --no-print-directory -C ${S32_DT2C_PATH}
+
+${S32_DT_CONFIG_SRC}: ${S32_DT2C} dtbs
+	${ECHO} "  CREATE  $@"
+	${Q}${S32_DT2C} ${BUILD_PLAT}/fdts/${DTB_FILE_NAME} $@
+
+.PHONY: clean_s32_dt2c
+clean: clean_s32_dt2c
+clean_s32_dt2c:
+	${Q}${MAKE} --no-print-directory -C ${S32_DT2C_PATH} clean
+endif
+
 ${BL2_W_DTB_SIZE_FILE}: ${BL2_W_DTB}
 	${ECHO} "  CREATE  $@"
 	${Q}$(call hexfilesize, $<) > $@
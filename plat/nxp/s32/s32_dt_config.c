@@ -0,0 +1,85 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <common/debug.h>
+#include <libfdt.h>
+#include <s32_dt.h>
+#include <s32_dt_config.h>
+
+#define FNV1A_BASIS		U(0x811c9dc5)
+#define FNV1A_PRIME		U(0x01000193)
+
+/*
+ * FNV-1a over the big-endian words of the blob, then its last bytes. Must
+ * match dtb_hash() of tools/nxp/s32_dt2c.
+ */
+static uint32_t dtb_hash(const void *fdt, size_t size)
+{
+	const fdt32_t *words = fdt;
+	const uint8_t *bytes = fdt;
+	uint32_t hash = FNV1A_BASIS;
+	size_t i;
+
+	for (i = 0U; i < size / sizeof(*words); i++) {
+		hash ^= fdt32_to_cpu(words[i]);
+		hash *= FNV1A_PRIME;
+	}
+
+	for (i *= sizeof(*words); i < size; i++) {
+		hash ^= bytes[i];
+		hash *= FNV1A_PRIME;
+	}
+
+	return hash;
+}
+
+/*
+ * The configuration which was extracted from the DTB at build time, if the
+ * DTB of BL2 is still that one. It is checked once per boot stage.
+ */
+const struct s32_dt_config *dt_get_static_config(void)
+{
+	static enum {
+		STATIC_CONFIG_UNCHECKED,
+		STATIC_CONFIG_VALID,
+		STATIC_CONFIG_INVALID,
+	} state = STATIC_CONFIG_UNCHECKED;
+	const struct s32_dt_config *cfg = &s32_dt_static_config;
+	void *fdt = NULL;
+
+	if (state == STATIC_CONFIG_UNCHECKED) {
+		state = STATIC_CONFIG_INVALID;
+
+		if ((dt_open_and_check() == 0) &&
+		    (fdt_get_address(&fdt) != 0) &&
+		    (fdt_totalsize(fdt) == cfg->dtb_size) &&
+		    (dtb_hash(fdt, cfg->dtb_size) == cfg->dtb_hash))
+			state = STATIC_CONFIG_VALID;
+		else
+			WARN("DTB differs from the build, parsing it instead\n");
+	}
+
+	if (state != STATIC_CONFIG_VALID)
+		return NULL;
+
+	return cfg;
+}
+
+const struct s32_dt_i2c_config *dt_get_static_i2c(int node)
+{
+	const struct s32_dt_config *cfg = dt_get_static_config();
+	unsigned int i;
+
+	if (cfg == NULL)
+		return NULL;
+
+	for (i = 0U; i < cfg->n_i2c; i++) {
+		if (cfg->i2c[i].node == node)
+			return &cfg->i2c[i];
+	}
+
+	return NULL;
+}
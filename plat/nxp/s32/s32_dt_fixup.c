@@ -0,0 +1,707 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <common/debug.h>
+#include <errno.h>
+#include <libfdt.h>
+#include <lib/utils_def.h>
+#include <s32_dt.h>
+#include <string.h>
+
+/*
+ * Batched fixups of a device tree. The edits are recorded against a source
+ * blob, which is not modified, so the node offsets found by the lookups stay
+ * valid while the fixups are collected. dt_fixup_apply() then writes the
+ * fixed-up tree to another buffer in a single walk of the source:
+ *   - the nodes and properties which are not edited are copied as they are,
+ *   - the edited properties are replaced, the removed ones are skipped,
+ *   - the new properties and nodes are added at the end of their parent,
+ *   - the strings block is copied, followed by the new property names.
+ * This spares a memmove of the rest of the blob for each edit.
+ */
+
+#ifndef S32_DT_FIXUP_EDITS
+#define S32_DT_FIXUP_EDITS	64U
+#endif
+
+#ifndef S32_DT_FIXUP_NODES
+#define S32_DT_FIXUP_NODES	8U
+#endif
+
+#ifndef S32_DT_FIXUP_POOL_SIZE
+#define S32_DT_FIXUP_POOL_SIZE	2048U
+#endif
+
+#define DT_FIXUP_STRINGS_SIZE	256U
+#define DT_FIXUP_MAX_DEPTH	32
+
+/* References of the nodes added by dt_fixup_add_subnode() */
+#define DT_FIXUP_NEW_NODE	0x40000000
+#define is_new_node(n)		((n) >= DT_FIXUP_NEW_NODE)
+
+#define HIGH_BITS(x) ((sizeof(x) > 4) ? ((x) >> 32) : (typeof(x))0)
+
+enum dt_edit_op {
+	DT_EDIT_SETPROP,
+	DT_EDIT_DELPROP,
+};
+
+struct dt_edit {
+	int node;
+	enum dt_edit_op op;
+	uint16_t name;		/* Offset in the pool */
+	uint16_t val;		/* Offset in the pool */
+	uint16_t len;
+	uint32_t nameoff;	/* Offset in the destination strings block */
+	bool done;
+};
+
+struct dt_new_node {
+	int parent;
+	uint16_t name;		/* Offset in the pool */
+};
+
+/* An open node of the source, while it is copied */
+struct dt_open_node {
+	int node;
+	unsigned int first_edit;
+	unsigned int n_edits;
+	bool new_props_done;
+};
+
+static struct {
+	const void *fdt;
+	unsigned int n_edits;
+	unsigned int n_nodes;
+	size_t pool_used;
+	size_t strings_used;
+	struct dt_edit edits[S32_DT_FIXUP_EDITS];
+	struct dt_new_node nodes[S32_DT_FIXUP_NODES];
+	char pool[S32_DT_FIXUP_POOL_SIZE];
+	char strings[DT_FIXUP_STRINGS_SIZE];
+	/* Destination buffer */
+	uint8_t *out;
+	size_t out_size;
+	size_t out_pos;
+} fixups;
+
+void dt_fixup_init(const void *fdt)
+{
+	fixups.fdt = fdt;
+	fixups.n_edits = 0U;
+	fixups.n_nodes = 0U;
+	fixups.pool_used = 0U;
+	fixups.strings_used = 0U;
+}
+
+static int pool_add(const void *data, size_t len, uint16_t *off)
+{
+	if (len > (S32_DT_FIXUP_POOL_SIZE - fixups.pool_used))
+		return -FDT_ERR_NOSPACE;
+
+	*off = (uint16_t)fixups.pool_used;
+	if (len != 0U)
+		memcpy(&fixups.pool[fixups.pool_used], data, len);
+	fixups.pool_used += len;
+
+	return 0;
+}
+
+static const char *pool_str(uint16_t off)
+{
+	return &fixups.pool[off];
+}
+
+static bool find_string(const char *strtab, size_t size, const char *s,
+			uint32_t *off)
+{
+	size_t pos = 0U, len;
+
+	while (pos < size) {
+		len = strnlen(&strtab[pos], size - pos);
+		if (strcmp(&strtab[pos], s) == 0) {
+			*off = (uint32_t)pos;
+			return true;
+		}
+
+		pos += len + 1U;
+	}
+
+	return false;
+}
+
+/*
+ * The destination strings block is the one of the source, followed by the
+ * names which are not in it.
+ */
+static int get_nameoff(const char *name, uint32_t *nameoff)
+{
+	const char *strtab = (const char *)fixups.fdt +
+			     fdt_off_dt_strings(fixups.fdt);
+	size_t strtab_size = fdt_size_dt_strings(fixups.fdt);
+	size_t len = strlen(name) + 1U;
+
+	if (find_string(strtab, strtab_size, name, nameoff))
+		return 0;
+
+	if (find_string(fixups.strings, fixups.strings_used, name, nameoff)) {
+		*nameoff += (uint32_t)strtab_size;
+		return 0;
+	}
+
+	if (len > (DT_FIXUP_STRINGS_SIZE - fixups.strings_used))
+		return -FDT_ERR_NOSPACE;
+
+	memcpy(&fixups.strings[fixups.strings_used], name, len);
+	*nameoff = (uint32_t)(strtab_size + fixups.strings_used);
+	fixups.strings_used += len;
+
+	return 0;
+}
+
+static struct dt_edit *find_edit(int node, const char *name)
+{
+	unsigned int i;
+
+	for (i = 0U; i < fixups.n_edits; i++) {
+		if ((fixups.edits[i].node == node) &&
+		    (strcmp(pool_str(fixups.edits[i].name), name) == 0))
+			return &fixups.edits[i];
+	}
+
+	return NULL;
+}
+
+static int check_node(int node)
+{
+	int next;
+
+	if (is_new_node(node)) {
+		if ((unsigned int)(node - DT_FIXUP_NEW_NODE) >= fixups.n_nodes)
+			return -FDT_ERR_BADOFFSET;
+		return 0;
+	}
+
+	if ((node < 0) || ((node & (FDT_TAGSIZE - 1)) != 0))
+		return -FDT_ERR_BADOFFSET;
+
+	if (fdt_next_tag(fixups.fdt, node, &next) != FDT_BEGIN_NODE)
+		return -FDT_ERR_BADOFFSET;
+
+	return 0;
+}
+
+static int add_edit(int node, enum dt_edit_op op, const char *name,
+		    const void *val, int len)
+{
+	struct dt_edit *edit;
+	int ret;
+
+	ret = check_node(node);
+	if (ret)
+		return ret;
+
+	if ((len < 0) || (len > (int)UINT16_MAX))
+		return -FDT_ERR_BADVALUE;
+
+	/* A later edit of the same property replaces the earlier one */
+	edit = find_edit(node, name);
+	if (edit == NULL) {
+		if (fixups.n_edits == S32_DT_FIXUP_EDITS)
+			return -FDT_ERR_NOSPACE;
+
+		edit = &fixups.edits[fixups.n_edits];
+		ret = pool_add(name, strlen(name) + 1U, &edit->name);
+		if (ret)
+			return ret;
+
+		edit->node = node;
+		fixups.n_edits++;
+	}
+
+	edit->op = op;
+	edit->len = (uint16_t)len;
+	edit->done = false;
+
+	if (op == DT_EDIT_DELPROP)
+		return 0;
+
+	ret = pool_add(val, (size_t)len, &edit->val);
+	if (ret)
+		return ret;
+
+	return get_nameoff(name, &edit->nameoff);
+}
+
+/* Same as fdt_setprop(), 'node' is a node of the source or an added one */
+int dt_fixup_setprop(int node, const char *name, const void *val, int len)
+{
+	return add_edit(node, DT_EDIT_SETPROP, name, val, len);
+}
+
+int dt_fixup_setprop_u32(int node, const char *name, uint32_t val)
+{
+	fdt32_t tmp = cpu_to_fdt32(val);
+
+	return dt_fixup_setprop(node, name, &tmp, sizeof(tmp));
+}
+
+int dt_fixup_setprop_string(int node, const char *name, const char *str)
+{
+	return dt_fixup_setprop(node, name, str, (int)strlen(str) + 1);
+}
+
+/* Same as fdt_delprop(), only for the properties of the source */
+int dt_fixup_delprop(int node, const char *name)
+{
+	if (is_new_node(node))
+		return -FDT_ERR_BADOFFSET;
+
+	if (fdt_getprop(fixups.fdt, node, name, NULL) == NULL)
+		return -FDT_ERR_NOTFOUND;
+
+	return add_edit(node, DT_EDIT_DELPROP, name, NULL, 0);
+}
+
+/* Returns the reference of the new node, to be used by the other edits */
+int dt_fixup_add_subnode(int parent, const char *name)
+{
+	struct dt_new_node *node;
+	int ret;
+
+	ret = check_node(parent);
+	if (ret)
+		return ret;
+
+	if (!is_new_node(parent) &&
+	    (fdt_subnode_offset(fixups.fdt, parent, name) >= 0))
+		return -FDT_ERR_EXISTS;
+
+	if (fixups.n_nodes == S32_DT_FIXUP_NODES)
+		return -FDT_ERR_NOSPACE;
+
+	node = &fixups.nodes[fixups.n_nodes];
+	ret = pool_add(name, strlen(name) + 1U, &node->name);
+	if (ret)
+		return ret;
+
+	node->parent = parent;
+
+	return DT_FIXUP_NEW_NODE + (int)fixups.n_nodes++;
+}
+
+/* Same as fdt_add_reserved_memory() */
+int dt_fixup_add_reserved_memory(const char *node_name, uintptr_t base,
+				 size_t size)
+{
+	uint32_t addresses[4];
+	unsigned int idx = 0;
+	int offs, node, ac, sc, ret;
+
+	ac = fdt_address_cells(fixups.fdt, 0);
+	if (ac < 0)
+		return ac;
+
+	sc = fdt_size_cells(fixups.fdt, 0);
+	if (sc < 0)
+		return sc;
+
+	offs = dt_path_offset(fixups.fdt, "/reserved-memory");
+	if (offs < 0) {
+		offs = dt_fixup_add_subnode(0, "reserved-memory");
+		if (offs < 0)
+			return offs;
+
+		ret = dt_fixup_setprop_u32(offs, "#address-cells", ac);
+		if (ret)
+			return ret;
+
+		ret = dt_fixup_setprop_u32(offs, "#size-cells", sc);
+		if (ret)
+			return ret;
+
+		ret = dt_fixup_setprop(offs, "ranges", NULL, 0);
+		if (ret)
+			return ret;
+	}
+
+	if (ac > 1) {
+		addresses[idx] = cpu_to_fdt32(HIGH_BITS(base));
+		idx++;
+	}
+	addresses[idx] = cpu_to_fdt32(base & 0xffffffff);
+	idx++;
+	if (sc > 1) {
+		addresses[idx] = cpu_to_fdt32(HIGH_BITS(size));
+		idx++;
+	}
+	addresses[idx] = cpu_to_fdt32(size & 0xffffffff);
+	idx++;
+
+	node = -FDT_ERR_NOTFOUND;
+	if (!is_new_node(offs))
+		node = fdt_subnode_offset(fixups.fdt, offs, node_name);
+	if (node < 0)
+		node = dt_fixup_add_subnode(offs, node_name);
+	if (node < 0)
+		return node;
+
+	ret = dt_fixup_setprop(node, "no-map", NULL, 0);
+	if (ret)
+		return ret;
+
+	return dt_fixup_setprop(node, "reg", addresses,
+				idx * sizeof(uint32_t));
+}
+
+static int emit(const void *data, size_t len)
+{
+	if (len == 0U)
+		return 0;
+
+	if (len > (fixups.out_size - fixups.out_pos))
+		return -FDT_ERR_NOSPACE;
+
+	memcpy(&fixups.out[fixups.out_pos], data, len);
+	fixups.out_pos += len;
+
+	return 0;
+}
+
+static int emit_u32(uint32_t val)
+{
+	fdt32_t tmp = cpu_to_fdt32(val);
+
+	return emit(&tmp, sizeof(tmp));
+}
+
+static int emit_pad(void)
+{
+	size_t len = round_up(fixups.out_pos, FDT_TAGSIZE) - fixups.out_pos;
+	static const uint8_t zeros[FDT_TAGSIZE];
+
+	return emit(zeros, len);
+}
+
+static int emit_prop(const struct dt_edit *edit)
+{
+	int ret;
+
+	ret = emit_u32(FDT_PROP);
+	if (ret)
+		return ret;
+
+	ret = emit_u32(edit->len);
+	if (ret)
+		return ret;
+
+	ret = emit_u32(edit->nameoff);
+	if (ret)
+		return ret;
+
+	ret = emit(&fixups.pool[edit->val], edit->len);
+	if (ret)
+		return ret;
+
+	return emit_pad();
+}
+
+/* Copy a tag of the source, up to the next one */
+static int emit_src(int offset, int next)
+{
+	const uint8_t *src = (const uint8_t *)fixups.fdt +
+			     fdt_off_dt_struct(fixups.fdt);
+
+	return emit(&src[offset], (size_t)(next - offset));
+}
+
+/* Properties which are not in the source, in the order they were set */
+static int emit_new_props(int node, unsigned int first, unsigned int n)
+{
+	struct dt_edit *edit;
+	unsigned int i;
+	int ret;
+
+	for (i = first; i < first + n; i++) {
+		edit = &fixups.edits[i];
+		if ((edit->node != node) || edit->done ||
+		    (edit->op != DT_EDIT_SETPROP))
+			continue;
+
+		ret = emit_prop(edit);
+		if (ret)
+			return ret;
+
+		edit->done = true;
+	}
+
+	return 0;
+}
+
+static int emit_new_nodes(int parent, unsigned int depth)
+{
+	const char *name;
+	unsigned int i;
+	int node, ret;
+
+	if (depth >= DT_FIXUP_MAX_DEPTH)
+		return -FDT_ERR_BADSTRUCTURE;
+
+	for (i = 0U; i < fixups.n_nodes; i++) {
+		if (fixups.nodes[i].parent != parent)
+			continue;
+
+		node = DT_FIXUP_NEW_NODE + (int)i;
+		name = pool_str(fixups.nodes[i].name);
+
+		ret = emit_u32(FDT_BEGIN_NODE);
+		if (ret)
+			return ret;
+
+		ret = emit(name, strlen(name) + 1U);
+		if (ret)
+			return ret;
+
+		ret = emit_pad();
+		if (ret)
+			return ret;
+
+		ret = emit_new_props(node, 0U, fixups.n_edits);
+		if (ret)
+			return ret;
+
+		ret = emit_new_nodes(node, depth + 1U);
+		if (ret)
+			return ret;
+
+		ret = emit_u32(FDT_END_NODE);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int copy_prop(struct dt_open_node *node, int offset, int next)
+{
+	const struct fdt_property *prop;
+	struct dt_edit *edit;
+	const char *name;
+	unsigned int i;
+
+	if (node->n_edits == 0U)
+		return emit_src(offset, next);
+
+	prop = fdt_get_property_by_offset(fixups.fdt, offset, NULL);
+	if (prop == NULL)
+		return -FDT_ERR_BADSTRUCTURE;
+
+	name = fdt_string(fixups.fdt, fdt32_to_cpu(prop->nameoff));
+	if (name == NULL)
+		return -FDT_ERR_BADSTRUCTURE;
+
+	for (i = node->first_edit; i < node->first_edit + node->n_edits; i++) {
+		edit = &fixups.edits[i];
+		if (edit->done ||
+		    (strcmp(pool_str(edit->name), name) != 0))
+			continue;
+
+		edit->done = true;
+		if (edit->op == DT_EDIT_DELPROP)
+			return 0;
+
+		return emit_prop(edit);
+	}
+
+	return emit_src(offset, next);
+}
+
+/* Stable sort of the edits by node, which is the order of the walk */
+static void sort_edits(void)
+{
+	struct dt_edit tmp;
+	unsigned int i, j;
+
+	for (i = 1U; i < fixups.n_edits; i++) {
+		tmp = fixups.edits[i];
+		for (j = i; (j > 0U) && (fixups.edits[j - 1U].node > tmp.node);
+		     j--)
+			fixups.edits[j] = fixups.edits[j - 1U];
+		fixups.edits[j] = tmp;
+	}
+}
+
+static int copy_struct(void)
+{
+	struct dt_open_node stack[DT_FIXUP_MAX_DEPTH];
+	struct dt_open_node *node = NULL;
+	unsigned int cursor = 0U;
+	int depth = 0, offset = 0, next;
+	uint32_t tag;
+	int ret = 0;
+
+	do {
+		tag = fdt_next_tag(fixups.fdt, offset, &next);
+		if (next < 0)
+			return next;
+
+		switch (tag) {
+		case FDT_BEGIN_NODE:
+			if (depth == DT_FIXUP_MAX_DEPTH)
+				return -FDT_ERR_BADSTRUCTURE;
+
+			/* The properties of the parent go before its nodes */
+			if ((node != NULL) && !node->new_props_done) {
+				ret = emit_new_props(node->node,
+						     node->first_edit,
+						     node->n_edits);
+				node->new_props_done = true;
+				if (ret)
+					return ret;
+			}
+
+			while ((cursor < fixups.n_edits) &&
+			       (fixups.edits[cursor].node < offset))
+				cursor++;
+
+			node = &stack[depth++];
+			node->node = offset;
+			node->first_edit = cursor;
+			node->n_edits = 0U;
+			node->new_props_done = false;
+			while ((cursor < fixups.n_edits) &&
+			       (fixups.edits[cursor].node == offset)) {
+				node->n_edits++;
+				cursor++;
+			}
+
+			ret = emit_src(offset, next);
+			break;
+		case FDT_PROP:
+			if (node == NULL)
+				return -FDT_ERR_BADSTRUCTURE;
+
+			ret = copy_prop(node, offset, next);
+			break;
+		case FDT_END_NODE:
+			if (node == NULL)
+				return -FDT_ERR_BADSTRUCTURE;
+
+			if (!node->new_props_done) {
+				ret = emit_new_props(node->node,
+						     node->first_edit,
+						     node->n_edits);
+				if (ret)
+					return ret;
+			}
+
+			ret = emit_new_nodes(node->node, (unsigned int)depth);
+			if (ret)
+				return ret;
+
+			depth--;
+			node = (depth > 0) ? &stack[depth - 1] : NULL;
+			ret = emit_src(offset, next);
+			break;
+		case FDT_NOP:
+			break;
+		case FDT_END:
+			ret = emit_src(offset, next);
+			break;
+		default:
+			return -FDT_ERR_BADSTRUCTURE;
+		}
+
+		if (ret)
+			return ret;
+
+		offset = next;
+	} while (tag != FDT_END);
+
+	return 0;
+}
+
+static int check_edits(void)
+{
+	unsigned int i;
+
+	for (i = 0U; i < fixups.n_edits; i++) {
+		if (fixups.edits[i].done)
+			continue;
+
+		ERROR("Failed to apply a fixup of '%s' property\n",
+		      pool_str(fixups.edits[i].name));
+		return (fixups.edits[i].op == DT_EDIT_DELPROP) ?
+			-FDT_ERR_NOTFOUND : -FDT_ERR_BADOFFSET;
+	}
+
+	return 0;
+}
+
+/*
+ * Write the source device tree, with the recorded fixups, to 'blob'. The
+ * buffers must not overlap. The size of the resulting tree is returned in
+ * its header.
+ */
+int dt_fixup_apply(void *blob, size_t size)
+{
+	const void *fdt = fixups.fdt;
+	size_t off_rsvmap, off_struct, off_strings, rsvmap_size;
+	int ret, n_rsv;
+
+	n_rsv = fdt_num_mem_rsv(fdt);
+	if (n_rsv < 0)
+		return n_rsv;
+
+	off_rsvmap = round_up(sizeof(struct fdt_header), sizeof(uint64_t));
+	if (off_rsvmap > size)
+		return -FDT_ERR_NOSPACE;
+
+	fixups.out = blob;
+	fixups.out_size = size;
+	fixups.out_pos = off_rsvmap;
+
+	/* Including the terminating entry */
+	rsvmap_size = ((size_t)n_rsv + 1U) * sizeof(struct fdt_reserve_entry);
+	ret = emit((const uint8_t *)fdt + fdt_off_mem_rsvmap(fdt), rsvmap_size);
+	if (ret)
+		return ret;
+
+	sort_edits();
+
+	off_struct = fixups.out_pos;
+	ret = copy_struct();
+	if (ret)
+		return ret;
+
+	ret = check_edits();
+	if (ret)
+		return ret;
+
+	off_strings = fixups.out_pos;
+	ret = emit((const uint8_t *)fdt + fdt_off_dt_strings(fdt),
+		   fdt_size_dt_strings(fdt));
+	if (ret)
+		return ret;
+
+	ret = emit(fixups.strings, fixups.strings_used);
+	if (ret)
+		return ret;
+
+	memset(blob, 0, off_rsvmap);
+	fdt_set_magic(blob, FDT_MAGIC);
+	fdt_set_totalsize(blob, fixups.out_pos);
+	fdt_set_off_mem_rsvmap(blob, off_rsvmap);
+	fdt_set_off_dt_struct(blob, off_struct);
+	fdt_set_off_dt_strings(blob, off_strings);
+	fdt_set_version(blob, FDT_LAST_SUPPORTED_VERSION);
+	fdt_set_last_comp_version(blob, FDT_FIRST_SUPPORTED_VERSION);
+	fdt_set_boot_cpuid_phys(blob, fdt_boot_cpuid_phys(fdt));
+	fdt_set_size_dt_strings(blob, fixups.out_pos - off_strings);
+	fdt_set_size_dt_struct(blob, off_strings - off_struct);
+
+	return 0;
+}
@@ -0,0 +1,389 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <common/debug.h>
+#include <errno.h>
+#include <libfdt.h>
+#include <lib/utils_def.h>
+#include <s32_dt.h>
+#include <string.h>
+
+/*
+ * Lookup index of a device tree which is only read, e.g. the one BL2 and BL31
+ * probe their drivers from. It is built by a single walk of the structure
+ * block, the first time the blob is looked up, and maps:
+ *   - each string of the 'compatible' properties,
+ *   - each phandle,
+ *   - each node path
+ * to the nodes they belong to. A lookup is then a probe of a hash table,
+ * rather than a walk of the blob.
+ *
+ * The index is rebuilt if another blob is looked up, or if the structure
+ * block of the indexed one changed size, i.e. if its offsets moved. A blob
+ * which is being modified should still be looked up through libfdt. If the
+ * device tree does not fit, the lookups fall back to libfdt.
+ *
+ * It is meant for boot time and is not protected against concurrent use.
+ *
+ * BL2 runs from SRAM, so its index leaves the paths out: only the nodes with
+ * a compatible string or a phandle are recorded, in about 4.5 KiB, and the
+ * paths are looked up through libfdt. BL31 indexes the paths too, in about
+ * 16 KiB.
+ */
+
+#if defined(IMAGE_BL2)
+#define DT_INDEX_PATHS		0
+#ifndef S32_DT_INDEX_NODES
+#define S32_DT_INDEX_NODES	384U
+#endif
+#ifndef S32_DT_INDEX_SLOTS
+#define S32_DT_INDEX_SLOTS	512U
+#endif
+#else
+#define DT_INDEX_PATHS		1
+#ifndef S32_DT_INDEX_NODES
+#define S32_DT_INDEX_NODES	512U
+#endif
+#ifndef S32_DT_INDEX_SLOTS
+#define S32_DT_INDEX_SLOTS	2048U
+#endif
+#endif
+
+#define DT_INDEX_MAX_DEPTH	16
+#define DT_INDEX_MAX_FILL	(S32_DT_INDEX_SLOTS / 4U * 3U)
+#define DT_INDEX_SLOT(n)	((n) & (S32_DT_INDEX_SLOTS - 1U))
+
+#define FNV1A_BASIS		U(0x811c9dc5)
+#define FNV1A_PRIME		U(0x01000193)
+
+/* The slots are masked, rather than taken modulo */
+CASSERT((S32_DT_INDEX_SLOTS & (S32_DT_INDEX_SLOTS - 1U)) == 0U,
+	assert_s32_dt_index_slots_power_of_two);
+CASSERT(S32_DT_INDEX_NODES <= INT16_MAX, assert_s32_dt_index_nodes_fit);
+
+enum dt_key_type {
+	DT_KEY_COMPATIBLE = 1,
+	DT_KEY_PHANDLE,
+	DT_KEY_PATH,
+};
+
+struct dt_index_node {
+	int32_t offset;
+#if DT_INDEX_PATHS
+	int16_t parent;
+	uint16_t depth;
+#endif
+};
+
+static struct {
+	const void *fdt;
+	uint32_t size_dt_struct;
+	bool valid;
+	unsigned int n_nodes;
+	unsigned int n_slots;
+	struct dt_index_node nodes[S32_DT_INDEX_NODES];
+	/* Hash table of the nodes, 'keys' is 0 for an empty slot */
+	uint32_t keys[S32_DT_INDEX_SLOTS];
+	uint16_t slot_nodes[S32_DT_INDEX_SLOTS];
+} dt_index;
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len)
+{
+	const uint8_t *bytes = data;
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= FNV1A_PRIME;
+	}
+
+	return hash;
+}
+
+static uint32_t key_seed(enum dt_key_type type)
+{
+	uint8_t t = (uint8_t)type;
+
+	return fnv1a(FNV1A_BASIS, &t, sizeof(t));
+}
+
+/* 0 marks the empty slots */
+static uint32_t key_final(uint32_t hash)
+{
+	return (hash == 0U) ? 1U : hash;
+}
+
+static uint32_t key_of(enum dt_key_type type, const void *data, size_t len)
+{
+	return key_final(fnv1a(key_seed(type), data, len));
+}
+
+static int index_insert(uint32_t key, unsigned int node)
+{
+	unsigned int i;
+
+	if (dt_index.n_slots >= DT_INDEX_MAX_FILL)
+		return -ENOMEM;
+
+	for (i = DT_INDEX_SLOT(key); dt_index.keys[i] != 0U;
+	     i = DT_INDEX_SLOT(i + 1U))
+		;
+
+	dt_index.keys[i] = key;
+	dt_index.slot_nodes[i] = (uint16_t)node;
+	dt_index.n_slots++;
+
+	return 0;
+}
+
+/* Index the strings of a 'compatible' property and the phandle of a node */
+static int index_keys(unsigned int node, const char *compat, int len,
+		      uint32_t phandle)
+{
+	size_t slen;
+	int ret;
+
+	while ((compat != NULL) && (len > 0)) {
+		slen = strnlen(compat, (size_t)len);
+		ret = index_insert(key_of(DT_KEY_COMPATIBLE, compat, slen),
+				   node);
+		if (ret)
+			return ret;
+
+		compat += slen + 1U;
+		len -= (int)slen + 1;
+	}
+
+	if (phandle != 0U) {
+		ret = index_insert(key_of(DT_KEY_PHANDLE, &phandle,
+					  sizeof(phandle)), node);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+#if DT_INDEX_PATHS
+static int index_node(const void *fdt, int offset, int depth,
+		      uint32_t *path_hash, int16_t *parents)
+{
+	unsigned int node = dt_index.n_nodes;
+	const char *name, *compat;
+	int len, ret;
+
+	if (node >= S32_DT_INDEX_NODES || depth >= DT_INDEX_MAX_DEPTH)
+		return -ENOMEM;
+
+	dt_index.nodes[node].offset = offset;
+	dt_index.nodes[node].depth = (uint16_t)depth;
+	dt_index.nodes[node].parent = (depth == 0) ? -1 : parents[depth - 1];
+	dt_index.n_nodes++;
+	parents[depth] = (int16_t)node;
+
+	/* The path of a node is its parent's path, '/' and its name */
+	if (depth == 0) {
+		path_hash[0] = key_seed(DT_KEY_PATH);
+	} else {
+		name = fdt_get_name(fdt, offset, &len);
+		if (name == NULL)
+			return len;
+
+		path_hash[depth] = fnv1a(path_hash[depth - 1], "/", 1U);
+		path_hash[depth] = fnv1a(path_hash[depth], name, (size_t)len);
+
+		ret = index_insert(key_final(path_hash[depth]), node);
+		if (ret)
+			return ret;
+	}
+
+	compat = fdt_getprop(fdt, offset, "compatible", &len);
+
+	return index_keys(node, compat, len, fdt_get_phandle(fdt, offset));
+}
+#else
+/* Only the nodes which can be looked up by compatible or phandle */
+static int index_node(const void *fdt, int offset, int depth,
+		      uint32_t *path_hash, int16_t *parents)
+{
+	unsigned int node = dt_index.n_nodes;
+	const char *compat;
+	uint32_t phandle;
+	int len;
+
+	compat = fdt_getprop(fdt, offset, "compatible", &len);
+	phandle = fdt_get_phandle(fdt, offset);
+	if ((compat == NULL) && (phandle == 0U))
+		return 0;
+
+	if (node >= S32_DT_INDEX_NODES)
+		return -ENOMEM;
+
+	dt_index.nodes[node].offset = offset;
+	dt_index.n_nodes++;
+
+	return index_keys(node, compat, len, phandle);
+}
+#endif /* DT_INDEX_PATHS */
+
+static int index_build(const void *fdt)
+{
+	uint32_t path_hash[DT_INDEX_MAX_DEPTH];
+	int16_t parents[DT_INDEX_MAX_DEPTH];
+	int offset, depth = 0;
+	int ret;
+
+	memset(&dt_index, 0, sizeof(dt_index));
+
+	/* The depth drops below 0 past the end of the root node */
+	for (offset = 0; (offset >= 0) && (depth >= 0);
+	     offset = fdt_next_node(fdt, offset, &depth)) {
+		ret = index_node(fdt, offset, depth, path_hash, parents);
+		if (ret)
+			return ret;
+	}
+
+	if ((offset < 0) && (offset != -FDT_ERR_NOTFOUND))
+		return offset;
+
+	return 0;
+}
+
+static bool index_ready(const void *fdt)
+{
+	int ret;
+
+	if ((dt_index.fdt == fdt) &&
+	    (dt_index.size_dt_struct == fdt_size_dt_struct(fdt)))
+		return dt_index.valid;
+
+	ret = index_build(fdt);
+	if (ret) {
+		VERBOSE("DT at %p is not indexed (%d)\n", fdt, ret);
+		memset(&dt_index, 0, sizeof(dt_index));
+	} else {
+		dt_index.valid = true;
+	}
+
+	dt_index.fdt = fdt;
+	dt_index.size_dt_struct = fdt_size_dt_struct(fdt);
+
+	return dt_index.valid;
+}
+
+/* Same as fdt_node_offset_by_compatible() */
+int dt_node_offset_by_compatible(const void *fdt, int startoffset,
+				 const char *compatible)
+{
+	int best = -FDT_ERR_NOTFOUND;
+	uint32_t key;
+	unsigned int i;
+	int offset;
+
+	if (!index_ready(fdt))
+		return fdt_node_offset_by_compatible(fdt, startoffset,
+						     compatible);
+
+	key = key_of(DT_KEY_COMPATIBLE, compatible, strlen(compatible));
+
+	/* The first match after 'startoffset', in structure block order */
+	for (i = DT_INDEX_SLOT(key); dt_index.keys[i] != 0U;
+	     i = DT_INDEX_SLOT(i + 1U)) {
+		if (dt_index.keys[i] != key)
+			continue;
+
+		offset = dt_index.nodes[dt_index.slot_nodes[i]].offset;
+		if ((offset <= startoffset) || ((best >= 0) && (offset > best)))
+			continue;
+
+		if (fdt_node_check_compatible(fdt, offset, compatible) == 0)
+			best = offset;
+	}
+
+	return best;
+}
+
+/* Same as fdt_node_offset_by_phandle() */
+int dt_node_offset_by_phandle(const void *fdt, uint32_t phandle)
+{
+	uint32_t key;
+	unsigned int i;
+	int offset;
+
+	if ((phandle == 0U) || (phandle == UINT32_MAX) || !index_ready(fdt))
+		return fdt_node_offset_by_phandle(fdt, phandle);
+
+	key = key_of(DT_KEY_PHANDLE, &phandle, sizeof(phandle));
+
+	for (i = DT_INDEX_SLOT(key); dt_index.keys[i] != 0U;
+	     i = DT_INDEX_SLOT(i + 1U)) {
+		if (dt_index.keys[i] != key)
+			continue;
+
+		offset = dt_index.nodes[dt_index.slot_nodes[i]].offset;
+		if (fdt_get_phandle(fdt, offset) == phandle)
+			return offset;
+	}
+
+	return -FDT_ERR_NOTFOUND;
+}
+
+#if DT_INDEX_PATHS
+/* Compare the path of a node with 'path', from its last component up */
+static bool is_node_path(const void *fdt, unsigned int node, const char *path,
+			 size_t len)
+{
+	const struct dt_index_node *n = &dt_index.nodes[node];
+	const char *name;
+	int nlen;
+
+	while (n->depth > 0U) {
+		name = fdt_get_name(fdt, n->offset, &nlen);
+		if ((name == NULL) || (len < ((size_t)nlen + 1U)))
+			return false;
+
+		len -= (size_t)nlen;
+		if ((memcmp(&path[len], name, (size_t)nlen) != 0) ||
+		    (path[len - 1U] != '/'))
+			return false;
+
+		len--;
+		n = &dt_index.nodes[n->parent];
+	}
+
+	return len == 0U;
+}
+
+/*
+ * Same as fdt_path_offset(). Full paths are looked up in the index, anything
+ * else (aliases, unit addresses left out) is passed to libfdt.
+ */
+int dt_path_offset(const void *fdt, const char *path)
+{
+	size_t len = strlen(path);
+	uint32_t key;
+	unsigned int i;
+
+	if ((path[0] != '/') || (len < 2U) || !index_ready(fdt))
+		return fdt_path_offset(fdt, path);
+
+	key = key_final(fnv1a(key_seed(DT_KEY_PATH), path, len));
+
+	for (i = DT_INDEX_SLOT(key); dt_index.keys[i] != 0U;
+	     i = DT_INDEX_SLOT(i + 1U)) {
+		if ((dt_index.keys[i] == key) &&
+		    is_node_path(fdt, dt_index.slot_nodes[i], path, len))
+			return dt_index.nodes[dt_index.slot_nodes[i]].offset;
+	}
+
+	return fdt_path_offset(fdt, path);
+}
+#else
+int dt_path_offset(const void *fdt, const char *path)
+{
+	return fdt_path_offset(fdt, path);
+}
+#endif /* DT_INDEX_PATHS */
@@ -5,66 +5,95 @@
  *
  * This is based on plat/nxp/common/setup/ls_interrupt_mgmt.c
  */
+#include <arch_helpers.h>
 #include <bl31/interrupt_mgmt.h>
 #include <common/debug.h>
+#include <drivers/arm/gic_common.h>
+#include <lib/libc/errno.h>
 #include <plat/common/platform.h>
 
 #include <platform_def.h>
 #include <assert.h>
+#include <s32_interrupt_mgmt.h>
+#include <s32_trace.h>
 
 typedef struct s32_irq {
 	uint32_t id;
 	interrupt_type_handler_t handler;
 } s32_irq_t;
 
+/* Interrupt statistics of one core, updated by that core only */
+typedef struct s32_irq_core_stats {
+	s32_irq_stats_t irq[S32CC_MAX_IRQ_NUM];
+	s32_irq_stats_t total;
+} __aligned(CACHE_WRITEBACK_GRANULE) s32_irq_core_stats_t;
+
 static s32_irq_t s32_irq_map[S32CC_MAX_IRQ_NUM];
 static unsigned int irq_count;
 
-static interrupt_type_handler_t get_irq_handler(uint32_t id)
-{
-	unsigned int i;
+/* INTID to s32_irq_map index + 1, 0 if there is no handler */
+static uint8_t s32_irq_slot[MAX_SPI_ID + 1U];
+
+static s32_irq_core_stats_t s32_irq_stats[PLATFORM_CORE_COUNT];
+
+CASSERT(S32CC_MAX_IRQ_NUM < UINT8_MAX, assert_s32_irq_slot_fits_uint8);
 
-	for (i = 0; i < irq_count; i++) {
-		if (id == s32_irq_map[i].id)
-			return s32_irq_map[i].handler;
+static int get_irq_slot(uint32_t id)
+{
+	if ((id > MAX_SPI_ID) || (s32_irq_slot[id] == 0U)) {
+		return -ENOENT;
 	}
 
-	return NULL;
+	return s32_irq_slot[id] - 1;
 }
 
 static int set_irq_handler(uint32_t id, interrupt_type_handler_t handler)
 {
-	if (irq_count >= S32CC_MAX_IRQ_NUM || !handler) {
+	if (irq_count >= S32CC_MAX_IRQ_NUM || !handler || id > MAX_SPI_ID) {
 		return -EINVAL;
 	}
 
 	s32_irq_map[irq_count].id = id;
 	s32_irq_map[irq_count++].handler = handler;
 
+	/* Publish the handler before the INTID points to it */
+	dmbish();
+	s32_irq_slot[id] = irq_count;
+
 	return 0;
 }
 
 int request_intr_type_el3(uint32_t id, interrupt_type_handler_t handler)
 {
-	if (get_irq_handler(id) != NULL) {
+	if (get_irq_slot(id) >= 0) {
 		return -EALREADY;
 	}
 
 	return set_irq_handler(id, handler);
 }
 
+static void update_stats(s32_irq_stats_t *stats, uint64_t ticks)
+{
+	stats->count++;
+	stats->ticks += ticks;
+}
+
 static uint64_t s32cc_el3_irq_handler(uint32_t id, uint32_t flags,
 				      void *handle, void *cookie)
 {
+	s32_irq_core_stats_t *stats = &s32_irq_stats[plat_my_core_pos()];
 	uint32_t intr_id;
-	interrupt_type_handler_t handler;
+	uint64_t start, ticks;
+	int slot;
+
+	start = read_cntpct_el0();
 
 	intr_id = plat_ic_acknowledge_interrupt();
 	intr_id = plat_ic_get_interrupt_id(intr_id);
 
-	handler = get_irq_handler(intr_id);
-	if (handler != NULL) {
-		handler(intr_id, flags, handle, cookie);
+	slot = get_irq_slot(intr_id);
+	if (slot >= 0) {
+		s32_irq_map[slot].handler(intr_id, flags, handle, cookie);
 	}
 
 	/*
@@ -72,9 +101,61 @@ static uint64_t s32cc_el3_irq_handler(uint32_t id, uint32_t flags,
 	 */
 	plat_ic_end_of_interrupt(intr_id);
 
+	ticks = read_cntpct_el0() - start;
+	if (slot >= 0) {
+		update_stats(&stats->irq[slot], ticks);
+	}
+	update_stats(&stats->total, ticks);
+
+	S32_TRACE("irq: %u handled in %lu ticks\n", intr_id, ticks);
+
 	return 0U;
 }
 
+/*
+ * Get the interrupt statistics of the EL3 handler registered in 'slot', or of
+ * all EL3 interrupts if 'slot' is S32_IRQ_STATS_ALL. Statistics are summed up
+ * over all cores if 'core' is S32_IRQ_STATS_ALL.
+ */
+int s32_irq_get_stats(unsigned int slot, unsigned int core,
+		      uint32_t *intid, s32_irq_stats_t *stats)
+{
+	const s32_irq_stats_t *src;
+	unsigned int i, first, last;
+
+	if ((slot != S32_IRQ_STATS_ALL) && (slot >= irq_count)) {
+		return -EINVAL;
+	}
+
+	if (core == S32_IRQ_STATS_ALL) {
+		first = 0U;
+		last = PLATFORM_CORE_COUNT - 1U;
+	} else if (core < PLATFORM_CORE_COUNT) {
+		first = core;
+		last = core;
+	} else {
+		return -EINVAL;
+	}
+
+	*intid = (slot == S32_IRQ_STATS_ALL) ? INTR_ID_UNAVAILABLE :
+		 s32_irq_map[slot].id;
+	stats->count = 0U;
+	stats->ticks = 0U;
+
+	for (i = first; i <= last; i++) {
+		if (slot == S32_IRQ_STATS_ALL) {
+			src = &s32_irq_stats[i].total;
+		} else {
+			src = &s32_irq_stats[i].irq[slot];
+		}
+
+		stats->count += src->count;
+		stats->ticks += src->ticks;
+	}
+
+	return 0;
+}
+
 void s32cc_el3_interrupt_config(void)
 {
 	uint64_t flags = 0U;
@@ -1,11 +1,13 @@
 /*
- * Copyright 2021-2022 NXP
+ * Copyright 2021-2023 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
+#include <arch_helpers.h>
 #include <drivers/nxp/linflexuart.h>
 #include <platform.h>
 #include <platform_def.h>
+#include <s32_linflexuart.h>
 
 #if S32CC_EMU == 1
 #  define S32_UART_BAUDRATE	(7812500)
@@ -14,29 +16,192 @@
 #endif
 #define S32_UART_CLOCK_HZ	(125000000)
 
+#if S32_CONSOLE_RING == 1
+static int console_s32_putc(int character, struct console *cons);
+static void console_s32_flush(struct console *cons);
+#endif
+
 static struct console_linflex console = {
 	.base = S32_UART_BASE,
 	.clock = S32_UART_CLOCK_HZ,
 	.baud = S32_UART_BAUDRATE,
 	.console = {
+#if S32_CONSOLE_RING == 1
+		.putc = console_s32_putc,
+		.flush = console_s32_flush,
+#else
 		.putc = console_linflex_putc,
 		.flush = console_linflex_flush,
+#endif
 		.flags = CONSOLE_FLAG_BOOT | CONSOLE_FLAG_CRASH,
 		.base = S32_UART_BASE,
 	},
 };
 
+#if S32_CONSOLE_RING == 1
+/*
+ * Once DDR is initialized, the console output is written to a ring at the top
+ * of the protected zone, rather than waiting for the UART. The ring is drained
+ * to the TX FIFO of the UART as it has room: after each character, during the
+ * delays (see s32_delay_timer_init()) and, entirely, on console_flush() and
+ * on a crash. It is used by BL2 and by the cold boot of BL31, which run on a
+ * single core, so it is not locked. BL31 stops it before leaving the cold
+ * boot, the other cores then print straight to the UART.
+ *
+ * The ring is also passed to BL33 as the 'tf-a-log' reserved memory region,
+ * which the normal world may rewrite. Its header is only validated by
+ * ring_init(), then the indexes below are used and published to the header.
+ * The ring is started by BL2 and continued by BL31: 'head' counts the
+ * characters written since, the last min(head, size) of them are in 'data',
+ * at the index of their count modulo 'size'.
+ */
+#define S32_CONSOLE_RING_MAGIC	U(0x474f4c53)	/* "SLOG" */
+
+struct s32_console_ring {
+	uint32_t magic;
+	uint32_t size;
+	uint64_t head;
+	uint64_t tail;
+	char data[];
+};
+
+#define RING_DATA_SIZE		(S32_CONSOLE_RING_SIZE - \
+				 sizeof(struct s32_console_ring))
+
+static struct s32_console_ring *ring;
+static uint64_t ring_head;
+static uint64_t ring_tail;
+static bool ring_stopped;
+
+/* Writes the indexes to the header, for the readers */
+static void ring_publish(void)
+{
+	ring->head = ring_head;
+	ring->tail = ring_tail;
+}
+
+static void ring_drain(bool wait)
+{
+	uint64_t left = MIN(ring_head - ring_tail, (uint64_t)RING_DATA_SIZE);
+	char c;
+
+	for (; left != 0U; left--) {
+		c = ring->data[ring_tail % RING_DATA_SIZE];
+		if (console_linflex_tx(&console.console, (uint8_t)c, wait))
+			break;
+
+		ring_tail++;
+	}
+
+	ring_publish();
+}
+
+static void ring_put(char c)
+{
+	/* Full, wait for the UART */
+	if ((ring_head - ring_tail) == RING_DATA_SIZE) {
+		console_linflex_tx(&console.console,
+				   (uint8_t)ring->data[ring_tail % RING_DATA_SIZE],
+				   true);
+		ring_tail++;
+	}
+
+	ring->data[ring_head % RING_DATA_SIZE] = c;
+	ring_head++;
+}
+
+static int console_s32_putc(int character, struct console *cons)
+{
+	if (ring == NULL)
+		return console_linflex_putc(character, cons);
+
+	if (character == '\n')
+		ring_put('\r');
+
+	ring_put((char)character);
+	ring_drain(false);
+
+	return 0;
+}
+
+static void console_s32_flush(struct console *cons)
+{
+	if (ring != NULL) {
+		ring_drain(true);
+		flush_dcache_range((uintptr_t)ring, S32_CONSOLE_RING_SIZE);
+	}
+
+	console_linflex_flush(cons);
+}
+
+static void ring_init(bool keep)
+{
+	struct s32_console_ring *r = (void *)S32_CONSOLE_RING_BASE;
+
+	if (keep && (r->magic == S32_CONSOLE_RING_MAGIC) &&
+	    (r->size == RING_DATA_SIZE) && (r->head >= r->tail) &&
+	    ((r->head - r->tail) <= RING_DATA_SIZE)) {
+		ring_head = r->head;
+		ring_tail = r->tail;
+	} else {
+		r->magic = S32_CONSOLE_RING_MAGIC;
+		r->size = RING_DATA_SIZE;
+		ring_head = 0U;
+		ring_tail = 0U;
+	}
+
+	ring = r;
+	ring_publish();
+}
+
+void console_s32_ring_init(void)
+{
+	ring_init(false);
+}
+
+void console_s32_ring_stop(void)
+{
+	if (ring == NULL)
+		return;
+
+	console_s32_flush(&console.console);
+	ring = NULL;
+	ring_stopped = true;
+}
+
+void console_s32_drain(void)
+{
+	if ((ring != NULL) && (ring_tail != ring_head))
+		ring_drain(false);
+}
+#endif
+
 int console_s32_register(void)
 {
-	return console_linflex_register(&console);
+	int ret;
+
+	ret = console_linflex_register(&console);
+
+#if (S32_CONSOLE_RING == 1) && defined(IMAGE_BL31)
+	/* Continue the ring of BL2, but not when resuming from suspend */
+	if (!ret && !ring_stopped)
+		ring_init(true);
+#endif
+
+	return ret;
 }
 
 int s32_plat_crash_console_putc(int c)
 {
+#if S32_CONSOLE_RING == 1
+	if (ring != NULL)
+		ring_drain(true);
+#endif
+
 	return console_linflex_putc(c, &console.console);
 }
 
 void s32_plat_crash_console_flush(void)
 {
-	return console_linflex_flush(&console.console);
+	return console.console.flush(&console.console);
 }
@@ -200,6 +200,15 @@ bool is_a53_core_in_reset(uint32_t core)
 	return is_core_in_reset(S32_MC_ME_CA53_PART, core);
 }
 
+bool is_a53_core_in_wfi(uint32_t core)
+{
+	uint32_t stat;
+
+	stat = mmio_read_32(S32_MC_ME_PRTN_N_CORE_M_STAT(S32_MC_ME_CA53_PART,
+							core));
+	return ((stat & S32_MC_ME_PRTN_N_CORE_M_STAT_WFI_MASK) != 0);
+}
+
 static bool s32_core_clock_running(uint32_t part, uint32_t core)
 {
 	uint32_t stat;
@@ -1,5 +1,5 @@
 /*
- * Copyright 2019-2022 NXP
+ * Copyright 2019-2023 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,12 +7,15 @@
 #include "s32_lowlevel.h"
 #include "s32_ncore.h"
 #include "s32_plat_funcs.h"
+#include "s32_pmf.h"
 #include "s32_pmic.h"
+#include "s32_trace.h"
 
 #if defined(PLAT_s32g2) || defined(PLAT_s32g3)
 #include <lib/mmio.h>
 #include "s32g_bl_common.h"
 #include "s32g_mc_me.h"
+#include "s32g_resume.h"
 #else
 #include "s32_bl_common.h"
 #include "s32_mc_me.h"
@@ -25,6 +28,11 @@
 #include <plat/common/platform.h>
 #include <s32_scp_scmi.h>
 
+PMF_REGISTER_SERVICE_SMC(s32_cpu_on_svc, S32_PMF_CPU_ON_SVC_ID,
+			 S32_PMF_CPU_ON_TOTAL_IDS, PMF_STORE_ENABLE)
+PMF_REGISTER_SERVICE_SMC(s32_cpu_pwr_svc, S32_PMF_CPU_PWR_SVC_ID,
+			 S32_PMF_CPU_PWR_TOTAL_IDS, PMF_STORE_ENABLE)
+
 /* See firmware-design, psci-lib-integration-guide for details */
 /* Used by plat_secondary_cold_boot_setup */
 uintptr_t s32_warmboot_entry;
@@ -41,6 +49,56 @@ static bool is_core_in_secondary_cluster(int pos)
 	return (pos >= PLATFORM_CORE_COUNT / 2);
 }
 
+static unsigned int core_cluster(unsigned int pos)
+{
+	return is_core_in_secondary_cluster(pos) ? 1U : 0U;
+}
+
+static uint32_t cluster_caiu(unsigned int cluster)
+{
+	return (cluster == 0U) ? A53_CLUSTER0_CAIU : A53_CLUSTER1_CAIU;
+}
+
+/*
+ * Take a cluster out of the coherency domain once none of its cores runs.
+ *
+ * PSCI has already released its locks when this is called, so a sibling may
+ * be waking up at the same time. Both sides publish their state before
+ * checking the other one's, see cluster_online(): either the sibling is seen
+ * running and the CAIU is left online, or it waits for CLUSTER_PWRDN to be
+ * cleared before turning the CAIU back on.
+ */
+static void cluster_offline(unsigned int cluster)
+{
+	unsigned int pos = plat_my_core_pos();
+	uint32_t caiu = cluster_caiu(cluster);
+
+	update_core_state(pos, CLUSTER_PWRDN(cluster), CLUSTER_PWRDN(cluster));
+	dsbsy();
+
+	if (is_cluster_idle(cluster) && ncore_is_caiu_online(caiu))
+		ncore_caiu_offline(caiu);
+
+	dsbsy();
+	update_core_state(pos, CLUSTER_PWRDN(cluster), 0);
+}
+
+/*
+ * Bring a cluster back into the coherency domain. The core about to run in
+ * it must already be marked as such, through CPU_ON.
+ */
+static void cluster_online(unsigned int cluster)
+{
+	uint32_t caiu = cluster_caiu(cluster);
+
+	dsbsy();
+	while (is_cluster_pwrdn(cluster))
+		;
+
+	if (!ncore_is_caiu_online(caiu))
+		ncore_caiu_online(caiu);
+}
+
 /** Executed by the primary core as part of the PSCI_CPU_ON call,
  *  e.g. during Linux kernel boot.
  */
@@ -48,12 +106,18 @@ static int s32_pwr_domain_on(u_register_t mpidr)
 {
 	int pos;
 	int ret;
+	uint32_t release = CPU_ON;
 	uintptr_t core_start_addr = (uintptr_t)&plat_secondary_cold_boot_setup;
 
+	PMF_CAPTURE_TIMESTAMP(s32_cpu_on_svc, S32_PMF_CPU_ON_ENTER,
+			      PMF_NO_CACHE_MAINT);
+
 	pos = plat_core_pos_by_mpidr(mpidr);
 	if (pos < 0)
 		return PSCI_E_INTERN_FAIL;
 
+	S32_TRACE("psci: cpu_on of core %d\n", pos);
+
 	dsbsy();
 
 	if (is_scp_used()) {
@@ -65,41 +129,48 @@ static int s32_pwr_domain_on(u_register_t mpidr)
 			s32_set_core_entrypoint(pos, core_start_addr);
 			s32_kick_secondary_ca53_core(pos);
 		} else {
-			update_core_state(pos, CPU_USE_WFI_FOR_SLEEP,
-					  CPU_USE_WFI_FOR_SLEEP);
+			release |= CPU_USE_WFI_FOR_SLEEP;
 		}
 	}
 
 	/* Do some chores on behalf of the secondary core. ICC setup must be
 	 * done by the secondaries, because the interface is not memory-mapped.
+	 * A core parked in sleep_wfi_loop() keeps its redistributor set up.
+	 * A context saved by SYSTEM_SUSPEND is restored first, so that the
+	 * setup below is applied on top of it, as it was before the suspend.
 	 */
-	gicv3_rdistif_init(pos);
-
-	/* Kick the secondary core out of wfi */
-	NOTICE("S32 TF-A: %s: booting up core %d (%u)\n", __func__, pos,
-	       get_core_state(pos, CPU_USE_WFI_FOR_SLEEP));
-
-	if (is_core_in_secondary_cluster(pos) &&
-	    !ncore_is_caiu_online(A53_CLUSTER1_CAIU))
-		ncore_caiu_online(A53_CLUSTER1_CAIU);
+	plat_gic_rdistif_online(pos);
+	if (!(release & CPU_USE_WFI_FOR_SLEEP))
+		gicv3_rdistif_init(pos);
 
-	if (!is_core_in_secondary_cluster(pos) &&
-	    !ncore_is_caiu_online(A53_CLUSTER0_CAIU))
-		ncore_caiu_online(A53_CLUSTER0_CAIU);
+	VERBOSE("S32 TF-A: %s: booting up core %d (%u)\n", __func__, pos,
+		!!(release & CPU_USE_WFI_FOR_SLEEP));
 
-	update_core_state(pos, CPU_ON, CPU_ON);
+	/*
+	 * Release the core through its mailbox. It waits for its cluster to be
+	 * online before enabling its caches.
+	 */
+	update_core_state(pos, CPU_ON | CPU_USE_WFI_FOR_SLEEP, release);
+	cluster_online(core_cluster(pos));
 
 	/* Wait GIC initialization */
 	while (get_core_state(pos, CPUIF_EN | CPU_ON) != (CPUIF_EN | CPU_ON));
 
 	/* Send an interrupt if the core is waiting in a WFI loop */
-	if (get_core_state(pos, CPU_USE_WFI_FOR_SLEEP)) {
+	if (release & CPU_USE_WFI_FOR_SLEEP) {
 		plat_ic_raise_el3_sgi(S32_SECONDARY_WAKE_SGI, mpidr);
 	}
 
+	PMF_CAPTURE_TIMESTAMP(s32_cpu_on_svc, S32_PMF_CPU_ON_RELEASE,
+			      PMF_NO_CACHE_MAINT);
+
 	return PSCI_E_SUCCESS;
 }
 
+/*
+ * Holding pen of the cores turned off without being reset. It runs with the
+ * data cache disabled, until the core is released by s32_pwr_domain_on().
+ */
 static void sleep_wfi_loop(void)
 {
 	u_register_t scr;
@@ -117,29 +188,35 @@ static void sleep_wfi_loop(void)
 		update_core_state(pos, CPUIF_EN, CPUIF_EN);
 	}
 
+	/*
+	 * Make sure interrupts are taken to EL3 before going into wfi. They
+	 * stay masked, so they only wake the core up.
+	 */
 	scr = read_scr_el3();
+	write_scr_el3(scr | SCR_IRQ_BIT | SCR_FIQ_BIT);
+	isb();
 
-	/* Make sure interrupts are taken to EL3 before going into wfi */
-	do {
-		write_scr_el3(scr | SCR_IRQ_BIT | SCR_FIQ_BIT);
-		isb();
+	while (!is_core_enabled(pos)) {
 		dsb();
 		wfi();
-		write_scr_el3(scr);
 
-		/* Restore SCR_EL3 */
 		intid = gicv3_get_pending_interrupt_id();
 		if (intid < MAX_SPI_ID) {
 			/* Mark it as consumed */
 			gicv3_clear_interrupt_pending(intid, pos);
 		}
+	}
 
-		if (is_core_enabled(pos) && intid == S32_SECONDARY_WAKE_SGI) {
-			break;
-		}
-	} while (true);
+	/* Restore SCR_EL3 */
+	write_scr_el3(scr);
+	isb();
 
 	gicv3_disable_interrupt(S32_SECONDARY_WAKE_SGI, pos);
+	/* The core may have been released before the SGI was received */
+	gicv3_clear_interrupt_pending(S32_SECONDARY_WAKE_SGI, pos);
+
+	PMF_CAPTURE_TIMESTAMP(s32_cpu_on_svc, S32_PMF_CPU_ON_WAKE,
+			      PMF_CACHE_MAINT);
 }
 
 /** Executed by the woken (secondary) core after it exits the wfi holding pen
@@ -148,7 +225,10 @@ static void sleep_wfi_loop(void)
 static void s32_pwr_domain_on_finish(const psci_power_state_t *target_state)
 {
 	unsigned int pos = plat_my_core_pos();
-	NOTICE("S32 TF-A: %s: cpu %d running\n", __func__, pos);
+
+	PMF_CAPTURE_TIMESTAMP(s32_cpu_on_svc, S32_PMF_CPU_ON_FINISH,
+			      PMF_NO_CACHE_MAINT);
+	VERBOSE("S32 TF-A: %s: cpu %d running\n", __func__, pos);
 
 	update_core_state(pos, CPU_USE_WFI_FOR_SLEEP, 0);
 	if (!get_core_state(pos, CPUIF_EN)) {
@@ -157,24 +237,95 @@ static void s32_pwr_domain_on_finish(const psci_power_state_t *target_state)
 	}
 }
 
-#if defined(PLAT_s32g2) || defined(PLAT_s32g3)
-static void s32g_pwr_domain_suspend_finish(
+static void s32_pwr_domain_suspend_finish(
 					const psci_power_state_t *target_state)
 {
 	unsigned int pos = plat_my_core_pos();
 
-	NOTICE("S32G TF-A: %s\n", __func__);
+	PMF_CAPTURE_TIMESTAMP(s32_cpu_pwr_svc, S32_PMF_SUSPEND_FINISH,
+			      PMF_NO_CACHE_MAINT);
+
+	NOTICE("S32 TF-A: %s\n", __func__);
 	plat_gic_restore();
+#if defined(PLAT_s32g2) || defined(PLAT_s32g3)
+	s32g_resume_trace(S32G_RESUME_GIC);
+#endif
 
 	gicv3_cpuif_enable(pos);
 	update_core_state(pos, CPUIF_EN | CPU_ON, CPUIF_EN | CPU_ON);
+#if defined(PLAT_s32g2) || defined(PLAT_s32g3)
+	s32g_resume_trace(S32G_RESUME_DONE);
+#endif
 }
 
-static void s32g_pwr_domain_suspend(const psci_power_state_t *target_state)
+static void s32_pwr_domain_suspend(const psci_power_state_t *target_state)
 {
-	NOTICE("S32G TF-A: %s\n", __func__);
+	PMF_CAPTURE_TIMESTAMP(s32_cpu_pwr_svc, S32_PMF_SUSPEND_ENTER,
+			      PMF_CACHE_MAINT);
+
+	NOTICE("S32 TF-A: %s\n", __func__);
+
+	/* Mark the core as offline */
+	update_core_state(plat_my_core_pos(), CPU_ON, 0);
+}
+
+/*
+ * The only idle state of CPU_SUSPEND is the core standby: the core waits for
+ * an interrupt in wfi, with its context and caches retained. A core cannot be
+ * powered down through MC_ME without another core resetting it, so there is
+ * no power-down state for the core or the cluster. The system level is only
+ * reached through SYSTEM_SUSPEND.
+ */
+static int s32_validate_power_state(unsigned int power_state,
+				    psci_power_state_t *req_state)
+{
+	if (psci_get_pstate_type(power_state) != PSTATE_TYPE_STANDBY ||
+	    psci_get_pstate_pwrlvl(power_state) != MPIDR_AFFLVL0)
+		return PSCI_E_INVALID_PARAMS;
+
+	req_state->pwr_domain_state[MPIDR_AFFLVL0] = PLAT_MAX_RET_STATE;
+
+	return PSCI_E_SUCCESS;
 }
 
+static void s32_cpu_standby(plat_local_state_t cpu_state)
+{
+	u_register_t scr = read_scr_el3();
+
+	assert(cpu_state == PLAT_MAX_RET_STATE);
+
+	/* Let a pending interrupt wake the core, even if it is masked */
+	write_scr_el3(scr | SCR_IRQ_BIT | SCR_FIQ_BIT);
+	isb();
+	PMF_CAPTURE_TIMESTAMP(s32_cpu_pwr_svc, S32_PMF_STANDBY_WFI,
+			      PMF_NO_CACHE_MAINT);
+	dsb();
+	wfi();
+
+	PMF_CAPTURE_TIMESTAMP(s32_cpu_pwr_svc, S32_PMF_STANDBY_WAKE,
+			      PMF_NO_CACHE_MAINT);
+	write_scr_el3(scr);
+	isb();
+}
+
+#if ENABLE_PSCI_STAT
+/*
+ * Index of the PSCI statistics of a state: the core has a retention and an
+ * off state, the latter being only reached through SYSTEM_SUSPEND. The
+ * cluster and the system only have an off state.
+ */
+static int s32_get_pwr_lvl_state_idx(plat_local_state_t pwr_domain_state,
+				     int pwrlvl)
+{
+	if (pwrlvl == MPIDR_AFFLVL0 && is_local_state_retn(pwr_domain_state))
+		return 0;
+
+	assert(is_local_state_off(pwr_domain_state));
+	return (pwrlvl == MPIDR_AFFLVL0) ? 1 : 0;
+}
+#endif
+
+#if defined(PLAT_s32g2) || defined(PLAT_s32g3)
 static void s32g_get_sys_suspend_power_state(psci_power_state_t *req_state)
 {
 	int i;
@@ -198,22 +349,31 @@ static void __dead2 s32_pwr_domain_pwr_down_wfi(
 					const psci_power_state_t *target_state)
 {
 	unsigned int pos = plat_my_core_pos();
-	bool last_core = is_last_core();
+	bool last_core;
 	int ret;
 
-	NOTICE("S32 TF-A: %s: cpu = %u\n", __func__, pos);
+	/*
+	 * Only the core going through SYSTEM_SUSPEND, which PSCI lets through
+	 * once all the others are off, turns off the system level. Unlike the
+	 * CPU_ON flags, cleared before the cores get here, this cannot be seen
+	 * by two cores at once, e.g. by a core still on its way down from
+	 * CPU_OFF.
+	 */
+	last_core = is_local_state_off(
+			target_state->pwr_domain_state[PLAT_MAX_PWR_LVL]);
 
-	/* Mark the core as offline */
-	update_core_state(pos, CPUIF_EN | CPU_ON, 0);
+	VERBOSE("S32 TF-A: %s: cpu = %u\n", __func__, pos);
+
+	update_core_state(pos, CPUIF_EN, 0);
 	gicv3_cpuif_disable(pos);
 
 	if (!last_core) {
 		if (is_cluster0_off()) {
-			ncore_caiu_offline(A53_CLUSTER0_CAIU);
+			cluster_offline(0U);
 		}
 
 		if (is_cluster1_off()) {
-			ncore_caiu_offline(A53_CLUSTER1_CAIU);
+			cluster_offline(1U);
 		}
 
 		if (is_scp_used()) {
@@ -223,6 +383,9 @@ static void __dead2 s32_pwr_domain_pwr_down_wfi(
 				plat_panic_handler();
 			}
 		}
+
+		PMF_CAPTURE_TIMESTAMP(s32_cpu_pwr_svc, S32_PMF_CPU_OFF_WFI,
+				      PMF_CACHE_MAINT);
 		sleep_wfi_loop();
 		plat_secondary_cold_boot_setup();
 	}
@@ -235,7 +398,15 @@ static void __dead2 s32_pwr_domain_pwr_down_wfi(
 
 static void s32_pwr_domain_off(const psci_power_state_t *target_state)
 {
-	NOTICE("S32 TF-A: %s\n", __func__);
+	PMF_CAPTURE_TIMESTAMP(s32_cpu_pwr_svc, S32_PMF_CPU_OFF_ENTER,
+			      PMF_CACHE_MAINT);
+	VERBOSE("S32 TF-A: %s\n", __func__);
+
+	/*
+	 * Mark the core as offline before PSCI reports it as off, as from
+	 * then on it may be turned on again by another core.
+	 */
+	update_core_state(plat_my_core_pos(), CPU_ON, 0);
 }
 
 static void __dead2 s32_system_reset(void)
@@ -277,14 +448,19 @@ const plat_psci_ops_t s32_psci_pm_ops = {
 	.pwr_domain_on = s32_pwr_domain_on,
 	.pwr_domain_on_finish = s32_pwr_domain_on_finish,
 	.pwr_domain_pwr_down_wfi = s32_pwr_domain_pwr_down_wfi,
-#if defined(PLAT_s32g2) || defined(PLAT_s32g3)
 	/* cap: PSCI_CPU_SUSPEND_AARCH64 */
-	.pwr_domain_suspend = s32g_pwr_domain_suspend,
+	.pwr_domain_suspend = s32_pwr_domain_suspend,
+	.pwr_domain_suspend_finish = s32_pwr_domain_suspend_finish,
+	.validate_power_state = s32_validate_power_state,
+	.cpu_standby = s32_cpu_standby,
+#if ENABLE_PSCI_STAT
+	.get_pwr_lvl_state_idx = s32_get_pwr_lvl_state_idx,
+#endif
+#if defined(PLAT_s32g2) || defined(PLAT_s32g3)
 	/* cap: PSCI_SYSTEM_SUSPEND_AARCH64 */
 	.get_sys_suspend_power_state = s32g_get_sys_suspend_power_state,
 	.pwr_domain_suspend_pwrdown_early =
 					s32g_pwr_domain_suspend_pwrdown_early,
-	.pwr_domain_suspend_finish = s32g_pwr_domain_suspend_finish,
 #endif
 	.system_reset = s32_system_reset,
 	.system_off = s32_system_off,
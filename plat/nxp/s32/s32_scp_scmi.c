@@ -10,6 +10,7 @@
 #include <arm/css/scmi/scmi_logger.h>
 #include <arm/css/scmi/scmi_private.h>
 #include <lib/mmio.h>
+#include <lib/spinlock.h>
 #include <platform.h>
 #include <libc/errno.h>
 #include <libfdt.h>
@@ -25,11 +26,18 @@
 #include <s32_interrupt_mgmt.h>
 #include <plat/common/platform.h>
 #include <s32_dt.h>
+#include <s32_dt_config.h>
 #include <s32_scp_scmi.h>
 
+#define SCMI_GPIO_IRQ_NOTIF	(0x0u)
 #define SCMI_GPIO_ACK_IRQ	(0xFFu)
 #define MAX_INTERNAL_MSGS	(1)
 
+/* Queued GPIO notifications, must be a power of two */
+#define GPIO_NOTIF_SLOTS	(8u)
+#define GPIO_NOTIF_SIZE		(128u)
+#define GPIO_NOTIF_IDX(n)	((n) & (GPIO_NOTIF_SLOTS - 1u))
+
 #define IRQ_CELL_SIZE (3)
 
 typedef struct scp_mem {
@@ -70,6 +78,41 @@ struct scmi_intern_msg {
 static struct scmi_intern_msg intern_msgs[MAX_INTERNAL_MSGS];
 static size_t used_intern_msgs;
 
+CASSERT((GPIO_NOTIF_SLOTS & (GPIO_NOTIF_SLOTS - 1u)) == 0u,
+	assert_gpio_notif_slots_power_of_two);
+
+/*
+ * GPIO notifications received from the SCP, waiting to be forwarded to the
+ * OSPM. The SCP's channel is freed as soon as a notification is queued, so a
+ * burst of notifications does not wait for the OSPM to handle each of them.
+ * The OSPM gets one notification at a time and acknowledges it through
+ * SCMI_GPIO_ACK_IRQ, which forwards the next one. If the queue is full, the
+ * notification is left in the RX mailbox and queued by the next acknowledge.
+ *
+ * GPIO_IRQ_NOTIFICATION carries a bitmap of the pending GPIO IRQs, so one
+ * received while the newest queued notification is still waiting to be
+ * forwarded is merged into it. A burst of GPIO events then costs the OSPM a
+ * single interrupt and acknowledge, and does not fill the queue.
+ *
+ * The indices are free running. The queue is shared by the MSCM interrupt
+ * handler and the acknowledge of the OSPM, which may run on different cores,
+ * and is protected by 'gpio_notifs_lock':
+ *   - 'ospm_busy' is set while slots[tail] is forwarded to the OSPM and not
+ *     acknowledged yet,
+ *   - 'rx_stalled' is set while a notification is left in the RX mailbox,
+ *   - 'seq' counts the forwarded notifications. It is passed in the token of
+ *     the message header, so the OSPM can tell them apart.
+ */
+static spinlock_t gpio_notifs_lock;
+static struct {
+	uint8_t slots[GPIO_NOTIF_SLOTS][GPIO_NOTIF_SIZE];
+	unsigned int head;
+	unsigned int tail;
+	bool ospm_busy;
+	bool rx_stalled;
+	unsigned int seq;
+} gpio_notifs;
+
 static scmi_channel_t scmi_channels[PLATFORM_CORE_COUNT];
 static scmi_channel_plat_info_t s32_scmi_plat_info[PLATFORM_CORE_COUNT];
 static void *scmi_handles[PLATFORM_CORE_COUNT];
@@ -193,34 +236,138 @@ static size_t get_packet_size(uintptr_t scmi_packet)
 	return offsetof(mailbox_mem_t, msg_header) + mbx_mem->len;
 }
 
-static int scmi_gpio_eirq_ack(void *payload)
+/* Give the RX mailbox back to the SCP */
+static void free_rx_channel(mailbox_mem_t *mb)
 {
-	uintptr_t mb_addr = get_rx_mb_addr();
-	mailbox_mem_t *mb = (mailbox_mem_t *)mb_addr;
-
 	if (is_scmi_logger_enabled())
 		log_scmi_ack(mb, get_rx_md_addr());
 
-	/* Nothing to perform other than marking the channel as free */
 	SCMI_MARK_CHANNEL_FREE(mb->status);
-
-	return 0;
 }
 
-static void process_gpio_notification(mailbox_mem_t *mb)
+/*
+ * Forward the oldest queued notification to the OSPM, unless it still handles
+ * the previous one. Called with 'gpio_notifs_lock' held.
+ */
+static void forward_gpio_notification(void)
 {
-	uintptr_t mb_addr = (uintptr_t)mb;
-	size_t msg_size;
+	mailbox_mem_t *notif = (mailbox_mem_t *)scp_dt.ospm_notif_mem.base;
+	uintptr_t slot;
 
-	msg_size = get_packet_size(mb_addr);
-	if (msg_size > get_rx_mb_size())
+	if (gpio_notifs.ospm_busy || gpio_notifs.tail == gpio_notifs.head)
 		return;
 
-	memcpy((void *)scp_dt.ospm_notif_mem.base, mb, msg_size);
+	slot = (uintptr_t)gpio_notifs.slots[GPIO_NOTIF_IDX(gpio_notifs.tail)];
+	memcpy(notif, (void *)slot, get_packet_size(slot));
+	notif->msg_header = (notif->msg_header &
+		~(SCMI_MSG_TOKEN_MASK << SCMI_MSG_TOKEN_SHIFT)) |
+		((gpio_notifs.seq++ & SCMI_MSG_TOKEN_MASK) <<
+		 SCMI_MSG_TOKEN_SHIFT);
+	gpio_notifs.ospm_busy = true;
 
 	plat_ic_set_interrupt_pending(scp_dt.ospm_notif_irq);
 }
 
+/*
+ * Merge a GPIO_IRQ_NOTIFICATION into the newest queued notification, if it is
+ * of the same kind and size and has not been forwarded yet. Called with
+ * 'gpio_notifs_lock' held.
+ */
+static bool merge_gpio_notification(mailbox_mem_t *mb)
+{
+	uint32_t hdr_mask = ~(SCMI_MSG_TOKEN_MASK << SCMI_MSG_TOKEN_SHIFT);
+	unsigned int first = gpio_notifs.tail;
+	mailbox_mem_t *last;
+	size_t i, nwords;
+
+	if (gpio_notifs.ospm_busy)
+		first++;
+
+	if (gpio_notifs.head == first ||
+	    SCMI_MSG_GET_MSG_ID(mb->msg_header) != SCMI_GPIO_IRQ_NOTIF)
+		return false;
+
+	last = (mailbox_mem_t *)
+		gpio_notifs.slots[GPIO_NOTIF_IDX(gpio_notifs.head - 1u)];
+	if (((last->msg_header ^ mb->msg_header) & hdr_mask) != 0u ||
+	    last->len != mb->len || mb->len < sizeof(mb->msg_header))
+		return false;
+
+	nwords = (mb->len - sizeof(mb->msg_header)) / sizeof(mb->payload[0]);
+	for (i = 0u; i < nwords; i++)
+		last->payload[i] |= mb->payload[i];
+
+	return true;
+}
+
+/*
+ * Queue the notification of the RX mailbox and give the channel back, or
+ * leave it there if the queue is full. Called with 'gpio_notifs_lock' held.
+ */
+static void queue_gpio_notification(mailbox_mem_t *mb)
+{
+	size_t msg_size = get_packet_size((uintptr_t)mb);
+
+	if (merge_gpio_notification(mb)) {
+		gpio_notifs.rx_stalled = false;
+		free_rx_channel(mb);
+		return;
+	}
+
+	if (gpio_notifs.head - gpio_notifs.tail == GPIO_NOTIF_SLOTS) {
+		gpio_notifs.rx_stalled = true;
+		return;
+	}
+
+	gpio_notifs.rx_stalled = false;
+
+	if (msg_size > MIN((size_t)GPIO_NOTIF_SIZE,
+			   scp_dt.ospm_notif_mem.size)) {
+		WARN("Dropped GPIO notification of %zu bytes\n", msg_size);
+	} else {
+		memcpy(gpio_notifs.slots[GPIO_NOTIF_IDX(gpio_notifs.head)], mb,
+		       msg_size);
+		gpio_notifs.head++;
+	}
+
+	free_rx_channel(mb);
+	forward_gpio_notification();
+}
+
+/*
+ * SCMI_GPIO_ACK_IRQ from the OSPM: the forwarded notification has been
+ * handled, forward the next one.
+ */
+static int scmi_gpio_eirq_ack(void *payload)
+{
+	spin_lock(&gpio_notifs_lock);
+
+	if (!gpio_notifs.ospm_busy) {
+		spin_unlock(&gpio_notifs_lock);
+		WARN("Unexpected GPIO notification acknowledge\n");
+		return 0;
+	}
+
+	gpio_notifs.ospm_busy = false;
+	gpio_notifs.tail++;
+
+	if (gpio_notifs.rx_stalled)
+		queue_gpio_notification((mailbox_mem_t *)get_rx_mb_addr());
+	else
+		forward_gpio_notification();
+
+	spin_unlock(&gpio_notifs_lock);
+
+	return 0;
+}
+
+static void process_gpio_notification(mailbox_mem_t *mb)
+{
+	spin_lock(&gpio_notifs_lock);
+	queue_gpio_notification(mb);
+	spin_unlock(&gpio_notifs_lock);
+}
+
 static uint64_t mscm_interrupt_handler(uint32_t id, uint32_t flags,
 				       void *handle, void *cookie)
 {
@@ -254,7 +401,7 @@ static int scp_get_mb(void *fdt, int node, const char *name,
 		return -FDT_ERR_NOTFOUND;
 	}
 
-	mb_node = fdt_node_offset_by_phandle(fdt, fdt32_to_cpu(phandles[idx]));
+	mb_node = dt_node_offset_by_phandle(fdt, fdt32_to_cpu(phandles[idx]));
 	if (mb_node < 0) {
 		ERROR("Failed to get SCMI %s mailbox node.\n", name);
 		return -FDT_ERR_NOTFOUND;
@@ -364,7 +511,7 @@ static int scp_get_irq(void *fdt, int node, const char *prop_name, const char *s
 		return -FDT_ERR_NOTFOUND;
 	}
 
-	irq_node = fdt_node_offset_by_phandle(fdt, fdt32_to_cpu(irqs[IRQ_CELL_SIZE * idx]));
+	irq_node = dt_node_offset_by_phandle(fdt, fdt32_to_cpu(irqs[IRQ_CELL_SIZE * idx]));
 	if (irq_node < 0) {
 		ERROR("Failed to get SCMI %s irq node.\n", string);
 		return -FDT_ERR_NOTFOUND;
@@ -429,19 +576,90 @@ static int scp_get_irqs_from_fdt(void *fdt, int node, struct scmi_scp_dt_info *s
 	return ret;
 }
 
+static void scp_mem_from_static(scp_mem_t *mem, const struct s32_dt_mem *cfg)
+{
+	mem->base = cfg->base;
+	mem->size = cfg->size;
+}
+
+static void scp_irq_from_static(scp_irq_t *irq,
+				const struct s32_dt_scp_irq *cfg)
+{
+	irq->cpn = cfg->cpn;
+	irq->mscm_irq = cfg->mscm_irq;
+	irq->irq_num = cfg->irq_num;
+}
+
+/*
+ * Take the SCP configuration from the tables built with S32_DT_STATIC_CONFIG,
+ * if they hold everything scp_scmi_dt_init() would parse.
+ */
+static bool scp_dt_from_static_config(bool init_rx)
+{
+	const struct s32_dt_config *cfg = dt_get_static_config();
+	const struct s32_dt_scp_config *scp;
+	uint32_t needed = S32_DT_SCP_TX;
+	size_t i;
+
+	if (!cfg)
+		return false;
+
+	scp = &cfg->scp;
+
+	if (init_rx)
+		needed |= S32_DT_SCP_RX;
+
+	if (is_scmi_logger_enabled()) {
+		needed |= S32_DT_SCP_TX_MD;
+		if (init_rx)
+			needed |= S32_DT_SCP_RX_MD;
+	}
+
+	if ((scp->found & needed) != needed ||
+	    scp->n_tx_mbs < PLATFORM_CORE_COUNT ||
+	    ((needed & S32_DT_SCP_TX_MD) &&
+	     scp->n_tx_mds < PLATFORM_CORE_COUNT))
+		return false;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		scp_mem_from_static(&scp_dt.tx_mbs[i], &scp->tx_mbs[i]);
+		if (needed & S32_DT_SCP_TX_MD)
+			scp_mem_from_static(&scp_dt.tx_mds[i],
+					    &scp->tx_mds[i]);
+	}
+
+	scp_irq_from_static(&scp_dt.tx_irq, &scp->tx_irq);
+
+	if (init_rx) {
+		scp_mem_from_static(&scp_dt.rx_mb, &scp->rx_mb);
+		scp_mem_from_static(&scp_dt.ospm_notif_mem,
+				    &scp->ospm_notif_mem);
+		scp_irq_from_static(&scp_dt.rx_irq, &scp->rx_irq);
+		scp_dt.ospm_notif_irq = scp->ospm_notif_irq;
+	}
+
+	if (needed & S32_DT_SCP_RX_MD)
+		scp_mem_from_static(&scp_dt.rx_md, &scp->rx_md);
+
+	return true;
+}
+
 int scp_scmi_dt_init(bool init_rx)
 {
 	void *fdt = NULL;
 	int scmi_node;
 	int ret = 0;
 
+	if (scp_dt_from_static_config(init_rx))
+		return 0;
+
 	if (dt_open_and_check() < 0)
 		return -EINVAL;
 
 	if (fdt_get_address(&fdt) == 0)
 		return -EINVAL;
 
-	scmi_node = fdt_node_offset_by_compatible(fdt, -1, "arm,scmi-smc");
+	scmi_node = dt_node_offset_by_compatible(fdt, -1, "arm,scmi-smc");
 	if (scmi_node == -FDT_ERR_NOTFOUND)
 		return -ENODEV;
 
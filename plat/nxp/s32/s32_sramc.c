@@ -55,9 +55,12 @@ static bool in_overlap(uintptr_t s1, uintptr_t e1, uintptr_t s2, uintptr_t e2)
 	return MAX(s1, s2) <= MIN(e1, e2);
 }
 
-static void clear_sramc_range(uintptr_t base, uint32_t start_offset,
-			      uint32_t end_offset)
+static int start_sramc_range(struct s32_sram_clear_req *req, uintptr_t base,
+			     uint32_t start_offset, uint32_t end_offset)
 {
+	if (req->n_busy >= ARRAY_SIZE(req->busy))
+		return -ENOMEM;
+
 	/* Disable the controller */
 	mmio_write_32(base + SRAMC_PRAMCR_OFFSET, 0x0);
 
@@ -68,13 +71,21 @@ static void clear_sramc_range(uintptr_t base, uint32_t start_offset,
 	/* Initialization request */
 	mmio_write_32(base + SRAMC_PRAMCR_OFFSET, SRAMC_PRAMCR_INITREQ);
 
+	req->busy[req->n_busy++] = base;
+
+	return 0;
+}
+
+static void wait_sramc(uintptr_t base)
+{
 	while (!(mmio_read_32(base + SRAMC_PRAMSR_OFFSET) & SRAMC_PRAMSR_IDONE))
 		;
 	mmio_write_32(base + SRAMC_PRAMSR_OFFSET, SRAMC_PRAMSR_IDONE);
 }
 
-static void clear_sram_range(struct sram_ctrl *c, uintptr_t start_addr,
-			      uintptr_t end_addr)
+static int start_sram_range(struct s32_sram_clear_req *req,
+			    struct sram_ctrl *c, uintptr_t start_addr,
+			    uintptr_t end_addr)
 {
 	uintptr_t base = c->base_addr;
 	uint32_t start_offset, end_offset;
@@ -85,22 +96,62 @@ static void clear_sram_range(struct sram_ctrl *c, uintptr_t start_addr,
 	start_offset = c->a53_to_sramc_offset(start_addr);
 	end_offset = c->a53_to_sramc_offset(end_addr) - 1;
 
-	clear_sramc_range(base, start_offset, end_offset);
+	return start_sramc_range(req, base, start_offset, end_offset);
+}
+
+void s32_sram_clear_init(struct s32_sram_clear_req *req)
+{
+	req->n_busy = 0u;
+	req->start_ticks = read_cntpct_el0();
+}
+
+/*
+ * Wait for all the initializations started with 'req'.
+ *
+ * Return: the time elapsed since s32_sram_clear_init(), in system counter
+ * ticks.
+ */
+uint64_t s32_sram_clear_wait(struct s32_sram_clear_req *req)
+{
+	size_t i;
+
+	for (i = 0u; i < req->n_busy; i++)
+		wait_sramc(req->busy[i]);
+
+	req->n_busy = 0u;
+
+	return read_cntpct_el0() - req->start_ticks;
 }
 
 #ifdef SSRAMC_BASE_ADDR
+int s32_ssram_clear_start(struct s32_sram_clear_req *req)
+{
+	return start_sramc_range(req, SSRAMC_BASE_ADDR, 0x0, SSRAM_MAX_ADDR);
+}
+
 void s32_ssram_clear(void)
 {
-	clear_sramc_range(SSRAMC_BASE_ADDR, 0x0, SSRAM_MAX_ADDR);
+	struct s32_sram_clear_req req;
+
+	s32_sram_clear_init(&req);
+	if (!s32_ssram_clear_start(&req))
+		s32_sram_clear_wait(&req);
 }
 #endif
 
-int s32_sram_clear(uintptr_t start, uintptr_t end)
+/*
+ * Start the initialization of [start, end) by all the SRAM controllers it
+ * spans, without waiting for them. The unaligned ends are cleared before
+ * returning.
+ */
+int s32_sram_clear_start(struct s32_sram_clear_req *req, uintptr_t start,
+			 uintptr_t end)
 {
 	struct sram_ctrl *ctrls;
 	struct sram_ctrl *c;
 	size_t i, n_ctrls;
 	uintptr_t s, e;
+	int ret;
 
 	if (start == end)
 		return 0;
@@ -128,8 +179,22 @@ int s32_sram_clear(uintptr_t start, uintptr_t end)
 		s = MAX(start, (uintptr_t)c->min_sram_addr);
 		e = MIN(end, (uintptr_t)c->max_sram_addr);
 
-		clear_sram_range(c, s, e);
+		ret = start_sram_range(req, c, s, e);
+		if (ret)
+			return ret;
 	}
 
 	return 0;
 }
+
+int s32_sram_clear(uintptr_t start, uintptr_t end)
+{
+	struct s32_sram_clear_req req;
+	int ret;
+
+	s32_sram_clear_init(&req);
+	ret = s32_sram_clear_start(&req, start, end);
+	s32_sram_clear_wait(&req);
+
+	return ret;
+}
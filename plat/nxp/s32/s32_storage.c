@@ -20,6 +20,7 @@
 
 #include "s32_storage.h"
 #include "s32_bl_common.h"
+#include "s32_bootchart.h"
 #include "s32_dt.h"
 
 #ifdef SPD_opteed
@@ -249,6 +250,7 @@ int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
 
 	assert(image_id < ARRAY_SIZE(s32_policies));
 
+	s32_bootchart_mark(S32_BOOT_IMAGE_LOAD, image_id);
 	set_img_source(&s32_policies[image_id], image_id);
 
 	policy = &s32_policies[image_id];
@@ -280,7 +282,7 @@ void s32_io_setup(void)
 		goto err;
 
 	if (!fip_mmc_offset)
-		return;
+		goto out;
 
 	if (s32_mmc_register())
 		goto err;
@@ -293,6 +295,8 @@ void s32_io_setup(void)
 			&s32_mmc_dev_handle))
 		goto err;
 
+out:
+	s32_bootchart_mark(S32_BOOT_STORAGE, 0);
 	return;
 err:
 	ERROR("Error: %s failed\n", __func__);
@@ -3,16 +3,25 @@
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
+#include <errno.h>
 #include <clk/s32gen1_scmi_clk.h>
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <drivers/scmi.h>
+#include <lib/pmf/pmf.h>
 #include <scmi-msg/common.h>
 #include <s32_bl_common.h>
+#include <s32_interrupt_mgmt.h>
 #include <s32_scp_scmi.h>
 #include <s32_svc.h>
+#include <s32_trace.h>
+#if defined(PLAT_s32g2) || defined(PLAT_s32g3)
+#include <s32g_resume.h>
+#endif
 
 #define S32_SCMI_ID			0xc20000feU
+#define S32_IRQ_STATS_ID		0xc20000fdU
+#define S32_RESUME_TRACE_ID		0xc20000fcU
 
 #define MSG_ID(m)			((m) & 0xffU)
 #define MSG_TYPE(m)			(((m) >> 8) & 0x3U)
@@ -105,6 +114,9 @@ static int scmi_handler(uint32_t smc_fid, u_register_t x1,
 
 	scmi_process_message(&msg);
 
+	S32_TRACE("scmi: protocol 0x%x, message 0x%x, status %d\n",
+		  msg.protocol_id, msg.message_id, response->status);
+
 	mem->length = msg.out_size_out + 4;
 	mem->channel_status = 1;
 
@@ -119,6 +131,7 @@ static int scp_scmi_handler(uint32_t smc_fid, u_register_t x1,
 	int ret;
 
 	ret = send_scmi_to_scp(S32_OSPM_SCMI_MEM, S32_OSPM_SCMI_MEM_SIZE);
+	S32_TRACE("scmi: forwarded to the SCP, status %d\n", ret);
 	if (ret != SCMI_SUCCESS) {
 		response->status = ret;
 		mem->channel_status = 1;
@@ -128,6 +141,50 @@ static int scp_scmi_handler(uint32_t smc_fid, u_register_t x1,
 	return SMC_OK;
 }
 
+/*
+ * x1: index of the EL3 interrupt handler, or S32_IRQ_STATS_ALL
+ * x2: core index, or S32_IRQ_STATS_ALL
+ *
+ * Returns the INTID of the handler, the number of interrupts and the time they
+ * took in EL3, in system counter ticks.
+ */
+static uintptr_t irq_stats_handler(void *handle, u_register_t x1,
+				   u_register_t x2)
+{
+	s32_irq_stats_t stats;
+	uint32_t intid;
+
+	if (s32_irq_get_stats((unsigned int)x1, (unsigned int)x2,
+			      &intid, &stats) != 0) {
+		SMC_RET1(handle, SMC_ARCH_CALL_INVAL_PARAM);
+	}
+
+	SMC_RET4(handle, SMC_OK, intid, stats.count, stats.ticks);
+}
+
+#if defined(PLAT_s32g2) || defined(PLAT_s32g3)
+/*
+ * x1: resume milestone, see enum s32g_resume_stage
+ *
+ * Returns the STM ticks elapsed between the wake-up seen by BL2 and the
+ * milestone, during the last standby exit.
+ */
+static uintptr_t resume_trace_handler(void *handle, u_register_t x1)
+{
+	uint32_t ticks;
+	int ret;
+
+	ret = s32g_resume_trace_get((unsigned int)x1, &ticks);
+	if (ret == -EINVAL) {
+		SMC_RET1(handle, SMC_ARCH_CALL_INVAL_PARAM);
+	} else if (ret != 0) {
+		SMC_RET1(handle, SMC_ARCH_CALL_NOT_SUPPORTED);
+	}
+
+	SMC_RET2(handle, SMC_OK, ticks);
+}
+#endif
+
 uintptr_t s32_svc_smc_handler(uint32_t smc_fid,
 			       u_register_t x1,
 			       u_register_t x2,
@@ -137,6 +194,14 @@ uintptr_t s32_svc_smc_handler(uint32_t smc_fid,
 			       void *handle,
 			       u_register_t flags)
 {
+#if ENABLE_PMF
+	/* PMF timestamps, e.g. of the S32 PSCI paths or of PSCI_STAT */
+	if (is_pmf_fid(smc_fid)) {
+		return pmf_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+				       handle, flags);
+	}
+#endif
+
 	switch (smc_fid) {
 	case S32_SCMI_ID:
 		if (is_scp_used()) {
@@ -145,6 +210,12 @@ uintptr_t s32_svc_smc_handler(uint32_t smc_fid,
 			SMC_RET1(handle, scmi_handler(smc_fid, x1, x2, x3));
 		}
 		break;
+	case S32_IRQ_STATS_ID:
+		return irq_stats_handler(handle, x1, x2);
+#if defined(PLAT_s32g2) || defined(PLAT_s32g3)
+	case S32_RESUME_TRACE_ID:
+		return resume_trace_handler(handle, x1);
+#endif
 	default:
 		WARN("Unimplemented SIP Service Call: 0x%x\n", smc_fid);
 		SMC_RET1(handle, SMC_UNK);
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <plat/common/platform.h>
+#include <platform_def.h>
+#include <s32_trace.h>
+#include <string.h>
+
+/*
+ * The region is mapped non-secure and the normal world may rewrite it: its
+ * geometry and the write index of each core are kept in secure memory, the
+ * headers of the region are only written.
+ */
+static uintptr_t trace_base;
+static size_t trace_core_size;
+static unsigned int trace_n_entries;
+static uint64_t trace_head[PLATFORM_CORE_COUNT];
+
+CASSERT((sizeof(struct s32_trace_core) % CACHE_WRITEBACK_GRANULE) == 0U,
+	assert_s32_trace_core_size);
+CASSERT((sizeof(struct s32_trace_header) % CACHE_WRITEBACK_GRANULE) == 0U,
+	assert_s32_trace_header_size);
+
+static struct s32_trace_core *get_core(unsigned int core)
+{
+	return (struct s32_trace_core *)(trace_base +
+					 sizeof(struct s32_trace_header) +
+					 (core * trace_core_size));
+}
+
+/*
+ * Splits the region between the cores and clears it. The rings are not kept
+ * across boots, their entries refer to the strings of this BL31.
+ */
+void s32_trace_init(uintptr_t base, size_t size)
+{
+	struct s32_trace_header *hdr = (struct s32_trace_header *)base;
+	size_t core_size;
+
+	if (size < sizeof(*hdr))
+		return;
+
+	core_size = (size - sizeof(*hdr)) / PLATFORM_CORE_COUNT;
+	core_size = round_down(core_size, CACHE_WRITEBACK_GRANULE);
+	if (core_size < (sizeof(struct s32_trace_core) +
+			 sizeof(struct s32_trace_entry)))
+		return;
+
+	(void)memset(hdr, 0, size);
+
+	hdr->magic = S32_TRACE_MAGIC;
+	hdr->version = S32_TRACE_VERSION;
+	hdr->n_cores = PLATFORM_CORE_COUNT;
+	hdr->n_entries = (core_size - sizeof(struct s32_trace_core)) /
+			 sizeof(struct s32_trace_entry);
+	hdr->core_size = core_size;
+	hdr->entry_size = sizeof(struct s32_trace_entry);
+	hdr->freq = plat_get_syscnt_freq2();
+
+	(void)memset(trace_head, 0, sizeof(trace_head));
+	trace_core_size = core_size;
+	trace_n_entries = hdr->n_entries;
+	trace_base = base;
+}
+
+/*
+ * Each core only writes its own ring, the entries are not locked. They are
+ * dropped while the data cache of the core is disabled, e.g. on the power
+ * down paths, for the region to be only accessed through its mapping.
+ */
+void s32_trace_write(const char *fmt, unsigned int nargs, u_register_t a0,
+		     u_register_t a1, u_register_t a2, u_register_t a3)
+{
+	unsigned int core = plat_my_core_pos();
+	struct s32_trace_entry *entry;
+	struct s32_trace_core *tc;
+
+	if ((trace_base == 0U) || (core >= PLATFORM_CORE_COUNT) ||
+	    !is_dcache_enabled())
+		return;
+
+	tc = get_core(core);
+	entry = (struct s32_trace_entry *)(tc + 1) +
+		(trace_head[core] % trace_n_entries);
+
+	entry->time = read_cntpct_el0();
+	entry->fmt = (uintptr_t)fmt;
+	entry->core = (uint16_t)core;
+	entry->nargs = (uint16_t)nargs;
+	entry->args[0] = a0;
+	entry->args[1] = a1;
+	entry->args[2] = a2;
+	entry->args[3] = a3;
+
+	trace_head[core]++;
+	tc->head = trace_head[core];
+}
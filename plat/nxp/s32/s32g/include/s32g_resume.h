@@ -1,11 +1,27 @@
 /*
- * Copyright 2020-2021 NXP
+ * Copyright 2020-2021, 2023 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #ifndef S32G_RESUME_H
 #define S32G_RESUME_H
 
+#include <stdint.h>
+
+/* Milestones of the standby exit, in order */
+enum s32g_resume_stage {
+	S32G_RESUME_BL2,	/* BL2 found the SoC waking up */
+	S32G_RESUME_DDR,	/* DDR out of retention */
+	S32G_RESUME_BL31,	/* BL31 warm entry */
+	S32G_RESUME_GIC,	/* GIC distributor restored */
+	S32G_RESUME_DONE,	/* Back to the normal world */
+	S32G_RESUME_STAGES,
+};
+
 void s32g_resume_entrypoint(void);
 
+void s32g_resume_trace_start(void);
+void s32g_resume_trace(enum s32g_resume_stage stage);
+int s32g_resume_trace_get(unsigned int stage, uint32_t *ticks);
+
 #endif
@@ -5,6 +5,7 @@
  */
 
 #include <lib/mmio.h>
+#include <plat/common/platform.h>
 #include "s32g_clocks.h"
 #if (ERRATA_S32_050543 == 1)
 #include "s32_ddr_errata_funcs.h"
@@ -14,7 +15,9 @@
 #include "s32g_mc_rgm.h"
 #include "s32g_mc_me.h"
 #include "s32_bl2_el3.h"
+#include "s32_bootchart.h"
 #include "s32g_bl_common.h"
+#include "s32g_resume.h"
 #include "s32g_vr5510.h"
 #include "s32_pinctrl.h"
 #include "s32_sramc.h"
@@ -105,6 +108,8 @@ static const uintptr_t used_ips_base[] = {
 	DDR_ERRATA_REGION_BASE,
 	S32G_SSRAM_BASE,
 	GPR_BASE_PAGE_ADDR,
+	/* Resume milestones */
+	STM6_BASE_ADDR,
 };
 
 static const uintptr_t clock_ips[] = {
@@ -118,9 +123,6 @@ static const uintptr_t clock_ips[] = {
 static const uintptr_t scp_used_ips[] = {
 	S32_SCP_SCMI_MEM,
 	MSCM_BASE_ADDR,
-#if defined(STM6_BASE_ADDR)
-	STM6_BASE_ADDR,
-#endif
 };
 
 static const struct s32_mmu_filter non_scp_filters[] = {
@@ -153,6 +155,8 @@ static void resume_bl31(struct s32g_ssram_mailbox *ssram_mb)
 	size_t n_mmu_filters;
 	uintptr_t csr_addr;
 
+	s32g_resume_trace_start();
+
 	resume_entrypoint = ssram_mb->bl31_warm_entrypoint;
 	csr_addr = (uintptr_t)&ssram_mb->csr_settings[0];
 
@@ -185,6 +189,8 @@ static void resume_bl31(struct s32g_ssram_mailbox *ssram_mb)
 		panic();
 	}
 
+	s32g_resume_trace(S32G_RESUME_DDR);
+
 #if (ERRATA_S32_050543 == 1)
 	ddr_errata_update_flag(polling_needed);
 #endif
@@ -219,6 +225,7 @@ void bl2_el3_early_platform_setup(u_register_t arg0, u_register_t arg1,
 	}
 
 	s32_early_plat_init();
+	s32_bootchart_start();
 	console_s32_register();
 
 #ifdef HSE_SUPPORT
@@ -260,24 +267,56 @@ void bl2_el3_early_platform_setup(u_register_t arg0, u_register_t arg1,
 
 void bl2_el3_plat_arch_setup(void)
 {
+	struct s32_sram_clear_req sram_req;
+	uint64_t sram_ticks;
+
 	if (s32_el3_mmu_fixup(NULL, 0))
 		panic();
 
-	if (init_and_setup_pmic())
-		panic();
+	/*
+	 * All SRAM controllers initialize their range in parallel, while the
+	 * PMIC is set up. The DDR init populates SSRAM, so it waits for them.
+	 */
+	s32_sram_clear_init(&sram_req);
+	if (s32_sram_clear_start(&sram_req, S32_BL33_IMAGE_BASE,
+				 get_bl2_dtb_base()))
+		ERROR("Failed to initialize the BL33 SRAM\n");
 
-	s32_sram_clear(S32_BL33_IMAGE_BASE, get_bl2_dtb_base());
+	if (s32_ssram_clear_start(&sram_req))
+		ERROR("Failed to initialize SSRAM\n");
 
-	s32_ssram_clear();
+	if (init_and_setup_pmic())
+		panic();
+	s32_bootchart_mark(S32_BOOT_PMIC, 0);
 
 	clear_swt_faults();
 
+	sram_ticks = s32_sram_clear_wait(&sram_req);
+	s32_bootchart_mark(S32_BOOT_SRAM, 0);
+	VERBOSE("SRAM initialized in %llu us\n",
+		(unsigned long long)(sram_ticks * 1000000U /
+				     plat_get_syscnt_freq2()));
+
 	/* This will also populate CSR section from bl31ssram */
 	if (ddr_init()) {
 		ERROR("Failed to configure the DDR subsystem\n");
 		panic();
 	}
 
+	console_s32_ring_init();
+
+	if (s32_bootchart_init(S32_BOOTCHART_BASE, S32_BOOTCHART_SIZE))
+		VERBOSE("No boot timeline\n");
+
+	/*
+	 * With the inline ECC, ddr_init() has initialized the whole DDR with
+	 * the scrubber: the records of the previous boots are lost and the
+	 * buffer starts over, only a DDR resume keeps them.
+	 */
+	if (tf_log_buffer_init(S32_LOG_BUFFER_BASE, S32_LOG_BUFFER_SIZE,
+			       true))
+		ERROR("Failed to set up the log buffer\n");
+
 #if (ERRATA_S32_050543 == 1)
 	ddr_errata_update_flag(polling_needed);
 #endif
@@ -13,7 +13,6 @@
 #include <psci.h>
 #include <plat/common/platform.h>
 
-#include <drivers/generic_delay_timer.h>
 #include <ocotp.h>
 #include <platform_def.h>
 #include <pmic/vr5510.h>
@@ -85,7 +84,7 @@ void bl31_platform_setup(void)
 {
 	uintptr_t core_addr;
 
-	generic_delay_timer_init();
+	s32_delay_timer_init();
 
 	update_core_state(plat_my_core_pos(), CPU_ON, CPU_ON);
 	s32_gic_setup();
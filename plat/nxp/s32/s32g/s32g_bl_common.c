@@ -55,7 +55,7 @@ void dt_init_pmic(void)
 	pmic_node = -1;
 	/* Limit the search to VR5510 MU & FSU */
 	for (instance = 0u; instance < 2u; instance++) {
-		pmic_node = fdt_node_offset_by_compatible(fdt, pmic_node,
+		pmic_node = dt_node_offset_by_compatible(fdt, pmic_node,
 				"nxp,vr5510");
 		if (pmic_node == -1) {
 			ret = -EIO;
@@ -109,7 +109,7 @@ void dt_init_ocotp(void)
 		return;
 	}
 
-	ocotp_node = fdt_node_offset_by_compatible(fdt, -1,
+	ocotp_node = dt_node_offset_by_compatible(fdt, -1,
 			"nxp,s32g-ocotp");
 	if (ocotp_node == -1)
 		return;
@@ -137,7 +137,7 @@ void dt_init_wkpu(void)
 		return;
 	}
 
-	wkpu_node = fdt_node_offset_by_compatible(fdt, -1,
+	wkpu_node = dt_node_offset_by_compatible(fdt, -1,
 			"nxp,s32cc-wkpu");
 	if (wkpu_node == -1)
 		return;
@@ -9,11 +9,14 @@
 #include <s32_lowlevel.h>
 #include <s32gen1-wkpu.h>
 #include <s32_scp_scmi.h>
+#include <s32g_resume.h>
 
 void s32g_resume_entrypoint(void)
 {
 	uintptr_t core_addr;
 
+	s32g_resume_trace(S32G_RESUME_BL31);
+
 	if (!is_scp_used()) {
 		s32gen1_wkpu_reset();
 	}
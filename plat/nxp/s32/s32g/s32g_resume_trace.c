@@ -0,0 +1,79 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <arch_helpers.h>
+#include <errno.h>
+#include <drivers/nxp/s32/stm/s32_stm.h>
+#include <lib/mmio.h>
+#include <lib/utils_def.h>
+#include <plat/nxp/s32g/ssram_mailbox.h>
+#include "s32g_resume.h"
+
+/*
+ * The milestones of the standby exit are timestamped with the STM and kept
+ * in the standby SRAM mailbox, which is shared by BL2 and BL31 and cleared
+ * on cold boot. They are read from the normal world through a SiP call.
+ */
+
+#define TRACE_ADDR(field)	(BL31SSRAM_MAILBOX + \
+				 offsetof(struct s32g_ssram_mailbox, \
+					  resume_trace.field))
+
+CASSERT(S32G_RESUME_STAGES <= S32G_RESUME_TRACE_SLOTS,
+	assert_s32g_resume_trace_slots);
+
+static struct s32_stm stm = {
+	.base = STM6_BASE_ADDR,
+};
+
+static void trace_write(uintptr_t addr, uint32_t value)
+{
+	mmio_write_32(addr, value);
+
+	/* BL2 turns its MMU off before jumping into BL31 */
+	if (is_dcache_enabled())
+		flush_dcache_range(addr, sizeof(value));
+}
+
+/* Called by BL2 as soon as it finds the SoC waking up from standby */
+void s32g_resume_trace_start(void)
+{
+	/* The SCP may have kept the timer running */
+	if (!s32_stm_is_enabled(&stm))
+		s32_stm_enable(&stm, true);
+
+	trace_write(TRACE_ADDR(valid), 0);
+	s32g_resume_trace(S32G_RESUME_BL2);
+}
+
+void s32g_resume_trace(enum s32g_resume_stage stage)
+{
+	uint32_t valid;
+
+	trace_write(TRACE_ADDR(ticks) + stage * sizeof(uint32_t),
+		    s32_stm_get_count(&stm));
+
+	valid = mmio_read_32(TRACE_ADDR(valid));
+	trace_write(TRACE_ADDR(valid), valid | BIT_32(stage));
+}
+
+/* STM ticks elapsed between the wake-up seen by BL2 and a milestone */
+int s32g_resume_trace_get(unsigned int stage, uint32_t *ticks)
+{
+	uint32_t valid = mmio_read_32(TRACE_ADDR(valid));
+	uint32_t start;
+
+	if (stage >= S32G_RESUME_STAGES)
+		return -EINVAL;
+
+	if (!(valid & BIT_32(S32G_RESUME_BL2)) || !(valid & BIT_32(stage)))
+		return -ENOENT;
+
+	start = mmio_read_32(TRACE_ADDR(ticks));
+	*ticks = mmio_read_32(TRACE_ADDR(ticks) + stage * sizeof(uint32_t)) -
+		 start;
+
+	return 0;
+}
@@ -8,9 +8,11 @@
 #include "ddr_init.h"
 #include <lib/libc/errno.h>
 #include <lib/mmio.h>
+#include <plat/common/platform.h>
 #include "platform_def.h"
 #include "s32_bl_common.h"
 #include "s32_bl2_el3.h"
+#include "s32_bootchart.h"
 #if (ERRATA_S32_050543 == 1)
 #include "s32_ddr_errata_funcs.h"
 #endif
@@ -51,6 +53,7 @@ void bl2_el3_early_platform_setup(u_register_t arg0, u_register_t arg1,
 	clear_reset_cause();
 
 	s32_early_plat_init();
+	s32_bootchart_start();
 	console_s32_register();
 	s32_plat_config_sdhc_pinctrl();
 	s32_io_setup();
@@ -72,18 +75,45 @@ void bl2_el3_early_platform_setup(u_register_t arg0, u_register_t arg1,
 
 void bl2_el3_plat_arch_setup(void)
 {
+	struct s32_sram_clear_req sram_req;
+	uint64_t sram_ticks;
+
 	if (s32_el3_mmu_fixup(NULL, 0))
 		panic();
 
-	s32_sram_clear(S32_BL33_IMAGE_BASE, get_bl2_dtb_base());
+	/* The SRAM controllers initialize their range in parallel */
+	s32_sram_clear_init(&sram_req);
+	if (s32_sram_clear_start(&sram_req, S32_BL33_IMAGE_BASE,
+				 get_bl2_dtb_base()))
+		ERROR("Failed to initialize the BL33 SRAM\n");
 
 	clear_swt_faults();
 
+	sram_ticks = s32_sram_clear_wait(&sram_req);
+	s32_bootchart_mark(S32_BOOT_SRAM, 0);
+	VERBOSE("SRAM initialized in %llu us\n",
+		(unsigned long long)(sram_ticks * 1000000U /
+				     plat_get_syscnt_freq2()));
+
 	if (ddr_init()) {
 		ERROR("Failed to configure the DDR subsystem\n");
 		panic();
 	}
 
+	console_s32_ring_init();
+
+	if (s32_bootchart_init(S32_BOOTCHART_BASE, S32_BOOTCHART_SIZE))
+		VERBOSE("No boot timeline\n");
+
+	/*
+	 * With the inline ECC, ddr_init() has initialized the whole DDR with
+	 * the scrubber: the records of the previous boots are lost and the
+	 * buffer starts over, only a DDR resume keeps them.
+	 */
+	if (tf_log_buffer_init(S32_LOG_BUFFER_BASE, S32_LOG_BUFFER_SIZE,
+			       true))
+		ERROR("Failed to set up the log buffer\n");
+
 #if (ERRATA_S32_050543 == 1)
 	ddr_errata_update_flag(polling_needed);
 #endif
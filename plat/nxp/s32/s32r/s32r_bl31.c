@@ -4,7 +4,6 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #include <common/debug.h>
-#include <drivers/generic_delay_timer.h>
 #include <plat/common/platform.h>
 
 #include "s32_bl_common.h"
@@ -13,7 +12,7 @@
 
 void bl31_platform_setup(void)
 {
-	generic_delay_timer_init();
+	s32_delay_timer_init();
 
 	update_core_state(plat_my_core_pos(), CPU_ON, CPU_ON);
 	s32_gic_setup();
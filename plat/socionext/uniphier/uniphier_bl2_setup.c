@@ -9,6 +9,7 @@
 #include <platform_def.h>
 
 #include <common/bl_common.h>
+#include <common/boot_instr.h>
 #include <common/debug.h>
 #include <common/desc_image_load.h>
 #include <common/image_decompress.h>
@@ -150,12 +151,16 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 {
 	struct image_info *image_info = uniphier_get_image_info(image_id);
 #ifdef UNIPHIER_DECOMPRESS_GZIP
+	uint64_t start;
 	int ret;
 
 	if (!(image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
+		start = boot_instr_start();
 		ret = image_decompress(uniphier_get_image_info(image_id));
 		if (ret)
 			return ret;
+
+		boot_instr_end("decompress", image_id, start);
 	}
 #endif
 
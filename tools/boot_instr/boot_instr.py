@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+#
+# Copyright 2023 NXP
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Collect the BOOT_INSTR lines printed by TF-A built with
+# ENABLE_BOOT_INSTRUMENTATION=1, from one or more console logs, and report the
+# measurements of each (image, event, id) as JSON or CSV. The report can be
+# compared with a previous one, to detect regressions.
+#
+# See docs/perf/boot-instrumentation.rst.
+
+import argparse
+import csv
+import json
+import re
+import statistics
+import sys
+
+# BOOT_INSTR,<image>,<event>,<id>,<ticks>, anywhere in the line
+line_re = re.compile(r'BOOT_INSTR,(\w+),(\w+),(\d+),(\d+)')
+
+report_fields = ['image', 'event', 'id', 'count', 'min', 'median', 'max',
+                 'median_us']
+
+
+def parse_logs(files):
+    samples = {}
+    freqs = {}
+
+    for f in files:
+        for line in f:
+            m = line_re.search(line)
+            if m is None:
+                continue
+
+            image, event, ident, ticks = m.groups()
+            if event == 'freq':
+                freqs[image] = int(ticks)
+                continue
+
+            if event == 'dropped':
+                print('%s: %s samples dropped, increase '
+                      'BOOT_INSTR_MAX_SAMPLES' % (image, ticks),
+                      file=sys.stderr)
+                continue
+
+            key = (image, event, int(ident))
+            samples.setdefault(key, []).append(int(ticks))
+
+    return samples, freqs
+
+
+def make_report(samples, freqs):
+    report = []
+
+    for (image, event, ident), ticks in sorted(samples.items()):
+        median = int(statistics.median(ticks))
+        freq = freqs.get(image, 0)
+
+        report.append({
+            'image': image,
+            'event': event,
+            'id': ident,
+            'count': len(ticks),
+            'min': min(ticks),
+            'median': median,
+            'max': max(ticks),
+            'median_us': round(median * 1000000 / freq, 3) if freq else None,
+        })
+
+    return report
+
+
+def compare(report, baseline, threshold):
+    """Print and count the medians above the baseline by threshold percent"""
+    base = {(e['image'], e['event'], e['id']): e for e in baseline}
+    regressions = 0
+
+    for e in report:
+        key = (e['image'], e['event'], e['id'])
+        if key not in base:
+            print('new: %s %s %d: %d ticks' % (key + (e['median'],)),
+                  file=sys.stderr)
+            continue
+
+        ref = base.pop(key)['median']
+        if ref == 0:
+            continue
+
+        delta = (e['median'] - ref) * 100.0 / ref
+        if delta > threshold:
+            regressions += 1
+            print('REGRESSION: %s %s %d: %d -> %d ticks (%+.1f%%)' %
+                  (key + (ref, e['median'], delta)), file=sys.stderr)
+        elif delta < -threshold:
+            print('improved: %s %s %d: %d -> %d ticks (%+.1f%%)' %
+                  (key + (ref, e['median'], delta)), file=sys.stderr)
+
+    for key in sorted(base):
+        print('missing: %s %s %d' % key, file=sys.stderr)
+
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Report the TF-A boot path instrumentation')
+    parser.add_argument('logs', nargs='*', type=argparse.FileType('r'),
+                        help='console logs, one per boot (default: stdin)')
+    parser.add_argument('-f', '--format', choices=['json', 'csv'],
+                        default='json', help='format of the report')
+    parser.add_argument('-o', '--output', type=argparse.FileType('w'),
+                        default=sys.stdout, help='report file')
+    parser.add_argument('-b', '--baseline', type=argparse.FileType('r'),
+                        help='JSON report to compare the medians with')
+    parser.add_argument('-t', '--threshold', type=float, default=5.0,
+                        help='regression threshold, in percent (default: 5)')
+    args = parser.parse_args()
+
+    samples, freqs = parse_logs(args.logs or [sys.stdin])
+    if not samples:
+        print('no BOOT_INSTR lines found, was TF-A built with '
+              'ENABLE_BOOT_INSTRUMENTATION=1?', file=sys.stderr)
+        return 1
+
+    report = make_report(samples, freqs)
+
+    if args.format == 'json':
+        json.dump(report, args.output, indent=2)
+        args.output.write('\n')
+    else:
+        writer = csv.DictWriter(args.output, fieldnames=report_fields,
+                                lineterminator='\n')
+        writer.writeheader()
+        writer.writerows(report)
+
+    if args.baseline is not None:
+        if compare(report, json.load(args.baseline), args.threshold) != 0:
+            return 2
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
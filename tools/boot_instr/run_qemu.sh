@@ -0,0 +1,105 @@
+#!/bin/sh
+#
+# Copyright 2023 NXP
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Build TF-A for PLAT=qemu with ENABLE_BOOT_INSTRUMENTATION=1, boot it a few
+# times under qemu-system-aarch64 with "-icount shift=0" and report the
+# BOOT_INSTR lines of the console logs with boot_instr.py.
+#
+# See docs/perf/boot-instrumentation.rst.
+
+set -e
+
+usage() {
+	cat >&2 <<EOF
+usage: run_qemu.sh [options] -b bl33 [-- make options]
+  -b bl33	BL33 image, e.g. QEMU_EFI.fd or u-boot.bin
+  -k kernel	Linux kernel image, booted by BL33 (optional)
+  -i initrd	initrd of the kernel (optional)
+  -n runs	number of boots (default: 3)
+  -t seconds	duration of each boot (default: 60)
+  -B baseline	JSON report to compare the medians with
+  -o dir	output directory (default: build/boot_instr)
+The toolchain is taken from CROSS_COMPILE (default: aarch64-none-elf-).
+EOF
+	exit 1
+}
+
+bl33=
+kernel=
+initrd=
+runs=3
+duration=60
+baseline=
+out=build/boot_instr
+
+while getopts "b:k:i:n:t:B:o:h" opt; do
+	case $opt in
+	b) bl33=$OPTARG ;;
+	k) kernel=$OPTARG ;;
+	i) initrd=$OPTARG ;;
+	n) runs=$OPTARG ;;
+	t) duration=$OPTARG ;;
+	B) baseline=$OPTARG ;;
+	o) out=$OPTARG ;;
+	*) usage ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+[ -n "$bl33" ] || usage
+# make runs from the top of the tree
+bl33=$(cd "$(dirname "$bl33")" && pwd)/$(basename "$bl33")
+
+CROSS_COMPILE=${CROSS_COMPILE:-aarch64-none-elf-}
+QEMU=${QEMU:-qemu-system-aarch64}
+top=$(cd "$(dirname "$0")/../.." && pwd)
+
+for tool in "${CROSS_COMPILE}gcc" "$QEMU" timeout python3; do
+	if ! command -v "$tool" > /dev/null; then
+		echo "run_qemu.sh: $tool not found" >&2
+		exit 1
+	fi
+done
+
+mkdir -p "$out"
+out=$(cd "$out" && pwd)
+build="$out/tf-a"
+
+make -C "$top" CROSS_COMPILE="$CROSS_COMPILE" PLAT=qemu \
+	ENABLE_BOOT_INSTRUMENTATION=1 BL33="$bl33" BUILD_BASE="$build" \
+	"$@" all fip
+
+# BL1 at the start of the secure flash, the FIP at 256 KiB
+bin=$(dirname "$(find "$build/qemu" -name bl1.bin | head -n 1)")
+rm -f "$out/flash.bin"
+dd if="$bin/bl1.bin" of="$out/flash.bin" bs=4096 conv=notrunc
+dd if="$bin/fip.bin" of="$out/flash.bin" seek=64 bs=4096 conv=notrunc
+
+set -- -nographic -machine virt,secure=on -cpu cortex-a57 -smp 4 -m 1024 \
+	-icount shift=0 -bios "$out/flash.bin" -monitor none
+[ -z "$kernel" ] || set -- "$@" -kernel "$kernel" \
+	-append "console=ttyAMA0,38400 keep_bootcon"
+[ -z "$initrd" ] || set -- "$@" -initrd "$initrd"
+
+logs=
+i=1
+while [ "$i" -le "$runs" ]; do
+	log="$out/boot-$i.log"
+	echo "run_qemu.sh: boot $i of $runs, $duration s" >&2
+
+	# The guest does not power off by itself, QEMU is stopped by timeout
+	timeout "$duration" "$QEMU" "$@" -serial "file:$log" || true
+
+	logs="$logs $log"
+	i=$((i + 1))
+done
+
+set -- -o "$out/report.json"
+[ -z "$baseline" ] || set -- "$@" -b "$baseline"
+
+# shellcheck disable=SC2086
+"$top/tools/boot_instr/boot_instr.py" "$@" $logs
+"$top/tools/boot_instr/boot_instr.py" -f csv $logs
@@ -70,6 +70,8 @@ int key_new(key_t *key);
 int key_create(key_t *key, int type, int key_bits);
 int key_load(key_t *key, unsigned int *err_code);
 int key_store(key_t *key);
+int key_cache_add(key_t *key);
+void key_cache_free(void);
 
 /* Macro to register the keys used in the CoT */
 #define REGISTER_KEYS(_keys) \
@@ -8,5 +8,8 @@
 #define SHA_H
 
 int sha_file(int md_alg, const char *filename, unsigned char *md);
+int sha_cache_get(int md_alg, const char *filename, unsigned char *md);
+int sha_cache_add(int md_alg, const char *filename, const unsigned char *md);
+void sha_cache_free(void);
 
 #endif /* SHA_H */
@@ -24,6 +24,73 @@
 key_t *keys;
 unsigned int num_keys;
 
+/*
+ * Keys loaded from (or created for) a file are kept until the tool exits, so
+ * that every CoT set of a batch which refers to the same file shares one key
+ * instead of parsing the PEM file again.
+ */
+typedef struct key_cache_s {
+	char *fn;
+	EVP_PKEY *key;
+	struct key_cache_s *next;
+} key_cache_t;
+
+static key_cache_t *key_cache;
+
+static EVP_PKEY *key_cache_get(const char *fn)
+{
+	key_cache_t *entry;
+
+	for (entry = key_cache; entry != NULL; entry = entry->next) {
+		if (strcmp(entry->fn, fn) == 0) {
+			return entry->key;
+		}
+	}
+
+	return NULL;
+}
+
+int key_cache_add(key_t *key)
+{
+	key_cache_t *entry;
+
+	if ((key->fn == NULL) || (key_cache_get(key->fn) != NULL)) {
+		return 1;
+	}
+
+	entry = malloc(sizeof(*entry));
+	if (entry == NULL) {
+		return 0;
+	}
+
+	entry->fn = malloc(strlen(key->fn) + 1);
+	if (entry->fn == NULL) {
+		free(entry);
+		return 0;
+	}
+	strcpy(entry->fn, key->fn);
+
+	EVP_PKEY_up_ref(key->key);
+	entry->key = key->key;
+	entry->next = key_cache;
+	key_cache = entry;
+
+	return 1;
+}
+
+void key_cache_free(void)
+{
+	key_cache_t *entry;
+
+	while (key_cache != NULL) {
+		entry = key_cache;
+		key_cache = entry->next;
+		EVP_PKEY_free(entry->key);
+		free(entry->fn);
+		free(entry);
+	}
+}
+
 /*
  * Create a new key container
  */
@@ -134,12 +201,22 @@ int key_load(key_t *key, unsigned int *err_code)
 	EVP_PKEY *k;
 
 	if (key->fn) {
+		/* Reuse the key if this file has already been loaded */
+		k = key_cache_get(key->fn);
+		if (k != NULL) {
+			EVP_PKEY_up_ref(k);
+			EVP_PKEY_free(key->key);
+			key->key = k;
+			*err_code = KEY_ERR_NONE;
+			return 1;
+		}
+
 		/* Load key from file */
 		fp = fopen(key->fn, "r");
 		if (fp) {
 			k = PEM_read_PrivateKey(fp, &key->key, NULL, NULL);
 			fclose(fp);
-			if (k) {
+			if (k && key_cache_add(key)) {
 				*err_code = KEY_ERR_NONE;
 				return 1;
 			} else {
@@ -1,5 +1,6 @@
 /*
  * Copyright (c) 2015-2021, ARM Limited and Contributors. All rights reserved.
+ * Copyright 2023 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,10 +8,12 @@
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <unistd.h>
 
 #include <openssl/conf.h>
 #include <openssl/engine.h>
@@ -65,6 +68,69 @@ static int key_size;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static int num_jobs;
+static char *batch_fn;
+
+/*
+ * Options given on the command line. In batch mode, they are restored before
+ * the options of each CoT set are applied on top of them.
+ */
+static struct {
+	int key_alg;
+	int hash_alg;
+	int key_size;
+	int new_keys;
+	int save_keys;
+	int print_cert;
+	char **ext_arg;
+	char **key_fn;
+	char **cert_fn;
+} cmd_line;
+
+/*
+ * Certificates signed by this invocation. A certificate is reused by later
+ * CoT sets of a batch when it is built from the same inputs.
+ */
+typedef struct cert_cache_s {
+	char *inputs;		/* Description of the certificate inputs */
+	X509 *x;		/* Certificate (one reference held) */
+	unsigned int uid;	/* Unique id of the certificate */
+} cert_cache_t;
+
+static cert_cache_t *cert_cache;
+static unsigned int *cert_uid;		/* Unique id of certs[i].x */
+static STACK_OF(X509_EXTENSION) **cert_sk;
+static unsigned int cot_set;
+
+/* Images hashed by the current CoT set */
+static const char **hash_fn;
+static unsigned char (*hash_md)[SHA512_DIGEST_LENGTH];
+
+/*
+ * Job pool. Jobs are started in index order by up to 'num_jobs' threads, as
+ * soon as the job_ready() callback allows it.
+ */
+enum {
+	JOB_PENDING,
+	JOB_RUNNING,
+	JOB_DONE
+};
+
+typedef int (*job_fn_t)(int idx);
+typedef int (*job_ready_fn_t)(int idx);
+
+static struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	unsigned char *state;
+	int num;
+	job_fn_t fn;
+	job_ready_fn_t ready;
+	int failed;
+} pool = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER
+};
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -113,6 +179,11 @@ static void print_help(const char *cmd, const struct option *long_opt)
 	printf("\n");
 	printf("Usage:\n");
 	printf("\t%s [OPTIONS]\n\n", cmd);
+	printf("In batch mode, each non-empty line of the batch file which does\n"
+	       "not start with '#' holds the options of one CoT set. They are\n"
+	       "applied on top of the options given on the command line.\n"
+	       "Keys, image hashes and certificates built from the same inputs\n"
+	       "are shared between the sets.\n\n");
 
 	printf("Available options:\n");
 	opt = long_opt;
@@ -288,63 +359,136 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of threads hashing images and signing certificates"
+		" (default: number of online CPUs)"
+	},
+	{
+		{ "batch", required_argument, NULL, 'B' },
+		"Generate one CoT set per line of the given file"
 	}
 };
 
-int main(int argc, char *argv[])
+static void *job_worker(void *arg)
 {
-	STACK_OF(X509_EXTENSION) * sk;
-	X509_EXTENSION *cert_ext = NULL;
-	ext_t *ext;
-	key_t *key;
-	cert_t *cert;
-	FILE *file;
-	int i, j, ext_nid, nvctr;
-	int c, opt_idx = 0;
-	const struct option *cmd_opt;
-	const char *cur_opt;
-	unsigned int err_code;
-	unsigned char md[SHA512_DIGEST_LENGTH];
-	unsigned int  md_len;
-	const EVP_MD *md_info;
+	int i, pending, rc;
 
-	NOTICE("CoT Generation Tool: %s\n", build_msg);
-	NOTICE("Target platform: %s\n", platform_msg);
+	pthread_mutex_lock(&pool.lock);
 
-	/* Set default options */
-	key_alg = KEY_ALG_RSA;
-	hash_alg = HASH_ALG_SHA256;
-	key_size = -1;
+	while (!pool.failed) {
+		/* Pick the first pending job which can be started */
+		pending = 0;
+		for (i = 0; i < pool.num; i++) {
+			if (pool.state[i] != JOB_PENDING) {
+				continue;
+			}
+			pending = 1;
+			if ((pool.ready == NULL) || pool.ready(i)) {
+				break;
+			}
+		}
 
-	/* Add common command line options */
-	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
-		cmd_opt_add(&common_cmd_opt[i]);
+		if (!pending) {
+			break;
+		}
+
+		if (i == pool.num) {
+			/* Wait for a running job to complete */
+			pthread_cond_wait(&pool.cond, &pool.lock);
+			continue;
+		}
+
+		pool.state[i] = JOB_RUNNING;
+		pthread_mutex_unlock(&pool.lock);
+
+		rc = pool.fn(i);
+
+		pthread_mutex_lock(&pool.lock);
+		pool.state[i] = JOB_DONE;
+		if (!rc) {
+			pool.failed = 1;
+		}
+		pthread_cond_broadcast(&pool.cond);
 	}
 
-	/* Initialize the certificates */
-	if (cert_init() != 0) {
-		ERROR("Cannot initialize certificates\n");
-		exit(1);
+	pthread_mutex_unlock(&pool.lock);
+
+	return NULL;
+}
+
+/*
+ * Run 'num' jobs and wait for all of them. The calling thread takes part.
+ *
+ * Return: 1 = success, 0 = at least one job failed
+ */
+static int run_jobs(int num, job_fn_t fn, job_ready_fn_t ready)
+{
+	pthread_t *threads;
+	int i, num_threads;
+
+	if (num == 0) {
+		return 1;
 	}
 
-	/* Initialize the keys */
-	if (key_init() != 0) {
-		ERROR("Cannot initialize keys\n");
-		exit(1);
+	CHECK_NULL(pool.state, calloc(num, sizeof(pool.state[0])));
+	pool.num = num;
+	pool.fn = fn;
+	pool.ready = ready;
+	pool.failed = 0;
+
+	num_threads = (num_jobs < num) ? num_jobs : num;
+	CHECK_NULL(threads, calloc(num_threads, sizeof(threads[0])));
+
+	for (i = 1; i < num_threads; i++) {
+		if (pthread_create(&threads[i], NULL, job_worker, NULL) != 0) {
+			/* Carry on with the threads we have */
+			break;
+		}
 	}
+	num_threads = i;
 
-	/* Initialize the new types and register OIDs for the extensions */
-	if (ext_init() != 0) {
-		ERROR("Cannot initialize extensions\n");
-		exit(1);
+	job_worker(NULL);
+
+	for (i = 1; i < num_threads; i++) {
+		pthread_join(threads[i], NULL);
 	}
 
-	/* Get the command line options populated during the initialization */
-	cmd_opt = cmd_opt_get_array();
+	free(threads);
+	free(pool.state);
+	pool.state = NULL;
+
+	return !pool.failed;
+}
+
+static void set_str(char **dst, const char *src)
+{
+	free(*dst);
+	*dst = NULL;
+	if (src != NULL) {
+		CHECK_NULL(*dst, strdup(src));
+	}
+}
+
+/*
+ * Parse the options of the command line, or of one line of the batch file.
+ */
+static void parse_opts(int argc, char *argv[], const char *cmd,
+		       const struct option *cmd_opt, int batch_line)
+{
+	int c, opt_idx = 0;
+	const char *cur_opt;
+	ext_t *ext;
+	key_t *key;
+	cert_t *cert;
+
+	/* Restart the scan for every line of the batch file */
+	optind = 1;
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:b:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:B:b:hj:knps:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -359,6 +503,13 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'B':
+			if (batch_line) {
+				ERROR("Batch files cannot be nested\n");
+				exit(1);
+			}
+			set_str(&batch_fn, optarg);
+			break;
 		case 'b':
 			key_size = get_key_size(optarg);
 			if (key_size <= 0) {
@@ -367,8 +518,19 @@ int main(int argc, char *argv[])
 			}
 			break;
 		case 'h':
-			print_help(argv[0], cmd_opt);
+			print_help(cmd, cmd_opt);
 			exit(0);
+		case 'j':
+			if (batch_line) {
+				ERROR("'--jobs' is only valid on the command line\n");
+				exit(1);
+			}
+			num_jobs = atoi(optarg);
+			if (num_jobs <= 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -388,45 +550,78 @@ int main(int argc, char *argv[])
 		case CMD_OPT_EXT:
 			cur_opt = cmd_opt_get_name(opt_idx);
 			ext = ext_get_by_opt(cur_opt);
-			ext->arg = strdup(optarg);
+			set_str((char **)&ext->arg, optarg);
 			break;
 		case CMD_OPT_KEY:
 			cur_opt = cmd_opt_get_name(opt_idx);
 			key = key_get_by_opt(cur_opt);
-			key->fn = strdup(optarg);
+			set_str(&key->fn, optarg);
 			break;
 		case CMD_OPT_CERT:
 			cur_opt = cmd_opt_get_name(opt_idx);
 			cert = cert_get_by_opt(cur_opt);
-			cert->fn = strdup(optarg);
+			set_str((char **)&cert->fn, optarg);
 			break;
 		case '?':
 		default:
-			print_help(argv[0], cmd_opt);
+			print_help(cmd, cmd_opt);
 			exit(1);
 		}
 	}
+}
 
-	/* Select a reasonable default key-size */
-	if (key_size == -1) {
-		key_size = KEY_SIZES[key_alg][0];
+static void save_cmd_line(void)
+{
+	int i;
+
+	cmd_line.key_alg = key_alg;
+	cmd_line.hash_alg = hash_alg;
+	cmd_line.key_size = key_size;
+	cmd_line.new_keys = new_keys;
+	cmd_line.save_keys = save_keys;
+	cmd_line.print_cert = print_cert;
+
+	CHECK_NULL(cmd_line.ext_arg, calloc(num_extensions, sizeof(char *)));
+	CHECK_NULL(cmd_line.key_fn, calloc(num_keys, sizeof(char *)));
+	CHECK_NULL(cmd_line.cert_fn, calloc(num_certs, sizeof(char *)));
+
+	for (i = 0; i < num_extensions; i++) {
+		set_str(&cmd_line.ext_arg[i], extensions[i].arg);
+	}
+	for (i = 0; i < num_keys; i++) {
+		set_str(&cmd_line.key_fn[i], keys[i].fn);
+	}
+	for (i = 0; i < num_certs; i++) {
+		set_str(&cmd_line.cert_fn[i], certs[i].fn);
 	}
+}
 
-	/* Check command line arguments */
-	check_cmd_params();
+static void restore_cmd_line(void)
+{
+	int i;
 
-	/* Indicate SHA as image hash algorithm in the certificate
-	 * extension */
-	if (hash_alg == HASH_ALG_SHA384) {
-		md_info = EVP_sha384();
-		md_len  = SHA384_DIGEST_LENGTH;
-	} else if (hash_alg == HASH_ALG_SHA512) {
-		md_info = EVP_sha512();
-		md_len  = SHA512_DIGEST_LENGTH;
-	} else {
-		md_info = EVP_sha256();
-		md_len  = SHA256_DIGEST_LENGTH;
+	key_alg = cmd_line.key_alg;
+	hash_alg = cmd_line.hash_alg;
+	key_size = cmd_line.key_size;
+	new_keys = cmd_line.new_keys;
+	save_keys = cmd_line.save_keys;
+	print_cert = cmd_line.print_cert;
+
+	for (i = 0; i < num_extensions; i++) {
+		set_str((char **)&extensions[i].arg, cmd_line.ext_arg[i]);
 	}
+	for (i = 0; i < num_keys; i++) {
+		set_str(&keys[i].fn, cmd_line.key_fn[i]);
+	}
+	for (i = 0; i < num_certs; i++) {
+		set_str((char **)&certs[i].fn, cmd_line.cert_fn[i]);
+	}
+}
+
+static void load_keys(void)
+{
+	unsigned int err_code;
+	int i;
 
 	/* Load private keys from files (or generate new ones) */
 	for (i = 0 ; i < num_keys ; i++) {
@@ -454,7 +649,8 @@ int main(int argc, char *argv[])
 		if (new_keys) {
 			/* Try to create a new key */
 			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg, key_size)) {
+			if (!key_create(&keys[i], key_alg, key_size) ||
+			    !key_cache_add(&keys[i])) {
 				ERROR("Error creating key '%s'\n", keys[i].desc);
 				exit(1);
 			}
@@ -467,96 +663,365 @@ int main(int argc, char *argv[])
 			exit(1);
 		}
 	}
+}
 
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
+static int hash_job(int idx)
+{
+	if (!sha_file(hash_alg, hash_fn[idx], hash_md[idx])) {
+		ERROR("Cannot calculate hash of %s\n", hash_fn[idx]);
+		return 0;
+	}
 
-		cert = &certs[i];
+	return 1;
+}
 
+/*
+ * Hash the images referenced by the requested certificates which have not been
+ * hashed yet. Images are hashed in parallel, each of them only once.
+ */
+static void hash_images(void)
+{
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	const cert_t *cert;
+	const ext_t *ext;
+	int i, j, k, num = 0;
+
+	for (i = 0; i < num_certs; i++) {
+		cert = &certs[i];
 		if (cert->fn == NULL) {
-			/* Certificate not requested. Skip to the next one */
 			continue;
 		}
 
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+		for (j = 0; j < cert->num_ext; j++) {
+			ext = &extensions[cert->ext[j]];
+			if ((ext->type != EXT_TYPE_HASH) || (ext->arg == NULL) ||
+			    sha_cache_get(hash_alg, ext->arg, md)) {
+				continue;
+			}
 
-		for (j = 0 ; j < cert->num_ext ; j++) {
+			for (k = 0; k < num; k++) {
+				if (strcmp(hash_fn[k], ext->arg) == 0) {
+					break;
+				}
+			}
+			if (k == num) {
+				hash_fn[num++] = ext->arg;
+			}
+		}
+	}
 
-			ext = &extensions[cert->ext[j]];
+	if (!run_jobs(num, hash_job, NULL)) {
+		exit(1);
+	}
 
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
+	for (k = 0; k < num; k++) {
+		if (!sha_cache_add(hash_alg, hash_fn[k], hash_md[k])) {
+			ERROR("%s:%d Failed to allocate memory.\n",
+			      __func__, __LINE__);
+			exit(1);
+		}
+	}
+}
 
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->optional && ext->arg == NULL) {
-					/* Skip this NVCounter */
-					continue;
+/*
+ * Create the stack of extensions of a certificate. The image hashes have been
+ * calculated by hash_images().
+ */
+static STACK_OF(X509_EXTENSION) *cert_new_exts(const cert_t *cert)
+{
+	STACK_OF(X509_EXTENSION) * sk;
+	X509_EXTENSION *cert_ext = NULL;
+	ext_t *ext;
+	int j, ext_nid, nvctr;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	unsigned int  md_len;
+	const EVP_MD *md_info;
+
+	/* Indicate SHA as image hash algorithm in the certificate
+	 * extension */
+	if (hash_alg == HASH_ALG_SHA384) {
+		md_info = EVP_sha384();
+		md_len  = SHA384_DIGEST_LENGTH;
+	} else if (hash_alg == HASH_ALG_SHA512) {
+		md_info = EVP_sha512();
+		md_len  = SHA512_DIGEST_LENGTH;
+	} else {
+		md_info = EVP_sha256();
+		md_len  = SHA256_DIGEST_LENGTH;
+	}
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext = &extensions[cert->ext[j]];
+
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->optional && ext->arg == NULL) {
+				/* Skip this NVCounter */
+				continue;
+			} else {
+				/* Checked by `check_cmd_params` */
+				assert(ext->arg != NULL);
+				nvctr = atoi(ext->arg);
+				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if (ext->arg == NULL) {
+				if (ext->optional) {
+					/* Include a hash filled with zeros */
+					memset(md, 0x0, SHA512_DIGEST_LENGTH);
 				} else {
-					/* Checked by `check_cmd_params` */
-					assert(ext->arg != NULL);
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
+					/* Do not include this hash in the certificate */
+					continue;
 				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA512_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						continue;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
+			} else {
+				/* Hash of the file, see hash_images() */
+				if (!sha_cache_get(hash_alg, ext->arg, md)) {
+					ERROR("Cannot calculate hash of %s\n",
+						ext->arg);
+					exit(1);
 				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						md_len));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
 			}
+			CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, md,
+					md_len));
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			exit(1);
+		}
+
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	return sk;
+}
+
+/* Issuer certificate which cert_new() takes the issuer identity from */
+static int cert_signed_by(int idx)
+{
+	int issuer = certs[idx].issuer;
+
+	/* Certificates are created in index order */
+	if ((issuer < idx) && (certs[issuer].fn != NULL)) {
+		return issuer;
+	}
+
+	return -1;
+}
+
+static int str_append(char **str, size_t *len, const char *s)
+{
+	size_t n = strlen(s);
+	char *p;
+
+	p = realloc(*str, *len + n + 2);
+	if (p == NULL) {
+		return 0;
+	}
+
+	memcpy(p + *len, s, n);
+	p[*len + n] = '|';
+	p[*len + n + 1] = '\0';
+	*len += n + 1;
+	*str = p;
+
+	return 1;
+}
+
+/*
+ * Describe everything a certificate is built from, except the serial number
+ * and the validity period. Certificates which use generated keys without a
+ * filename are never reused, so NULL is returned for them.
+ */
+static char *cert_inputs(int idx)
+{
+	const cert_t *cert = &certs[idx];
+	const ext_t *ext;
+	const char *fn;
+	char num[32];
+	char *str = NULL;
+	size_t len = 0;
+	int j, issuer;
+
+	issuer = cert_signed_by(idx);
+	snprintf(num, sizeof(num), "%d:%d:%u", hash_alg, cert->issuer,
+		 (issuer >= 0) ? cert_uid[issuer] : 0U);
+	if (!str_append(&str, &len, num)) {
+		goto err;
+	}
 
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
+	/* Subject and issuer keys */
+	fn = keys[cert->key].fn;
+	if ((fn == NULL) || !str_append(&str, &len, fn)) {
+		goto err;
+	}
+	fn = keys[certs[cert->issuer].key].fn;
+	if ((fn == NULL) || !str_append(&str, &len, fn)) {
+		goto err;
+	}
+
+	for (j = 0; j < cert->num_ext; j++) {
+		ext = &extensions[cert->ext[j]];
+		if (ext->type == EXT_TYPE_PKEY) {
+			fn = keys[ext->attr.key].fn;
+			if (fn == NULL) {
+				goto err;
+			}
+		} else {
+			fn = (ext->arg != NULL) ? ext->arg : "";
 		}
 
-		/* Create certificate. Signed with corresponding key */
-		if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
-			exit(1);
+		if (!str_append(&str, &len, fn)) {
+			goto err;
 		}
+	}
 
-		for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
-				cert_ext = sk_X509_EXTENSION_pop(sk)) {
-			X509_EXTENSION_free(cert_ext);
+	return str;
+err:
+	free(str);
+	return NULL;
+}
+
+static int sign_ready(int idx)
+{
+	int i, issuer = cert_signed_by(idx);
+
+	if ((issuer >= 0) && (pool.state[issuer] != JOB_DONE)) {
+		return 0;
+	}
+
+	/*
+	 * Certificates which come earlier and name this one as their issuer
+	 * must not see it, as in a sequential run.
+	 */
+	for (i = 0; i < idx; i++) {
+		if ((certs[i].issuer == idx) && (certs[i].fn != NULL) &&
+		    (pool.state[i] != JOB_DONE)) {
+			return 0;
 		}
+	}
+
+	return 1;
+}
+
+static int sign_job(int idx)
+{
+	cert_t *cert = &certs[idx];
+	cert_cache_t *cache = &cert_cache[idx];
+	char *inputs;
+
+	if (cert->fn == NULL) {
+		/* Certificate not requested. Skip to the next one */
+		return 1;
+	}
+
+	inputs = cert_inputs(idx);
 
-		sk_X509_EXTENSION_free(sk);
+	/* Reuse the certificate built by a previous CoT set */
+	if ((inputs != NULL) && (cache->inputs != NULL) &&
+	    (strcmp(inputs, cache->inputs) == 0)) {
+		X509_up_ref(cache->x);
+		cert->x = cache->x;
+		cert_uid[idx] = cache->uid;
+		free(inputs);
+		return 1;
 	}
 
+	/* Create certificate. Signed with corresponding key */
+	if (!cert_new(hash_alg, cert, VAL_DAYS, 0, cert_sk[idx])) {
+		ERROR("Cannot create %s\n", cert->cn);
+		free(inputs);
+		return 0;
+	}
+	cert_uid[idx] = cot_set * num_certs + idx + 1;
+
+	if (inputs != NULL) {
+		free(cache->inputs);
+		X509_free(cache->x);
+		X509_up_ref(cert->x);
+		cache->inputs = inputs;
+		cache->x = cert->x;
+		cache->uid = cert_uid[idx];
+	}
+
+	return 1;
+}
+
+/*
+ * Create and save the certificates (and keys) of one CoT set, as requested by
+ * the current options.
+ */
+static void generate_cot(void)
+{
+	X509_EXTENSION *cert_ext;
+	FILE *file;
+	int i;
+
+	/* Select a reasonable default key-size */
+	if (key_size == -1) {
+		key_size = KEY_SIZES[key_alg][0];
+	}
+
+	/* Check command line arguments */
+	check_cmd_params();
+
+	load_keys();
+
+	hash_images();
+
+	/* Create the extensions of the requested certificates */
+	for (i = 0 ; i < num_certs ; i++) {
+		cert_sk[i] = NULL;
+		if (certs[i].fn != NULL) {
+			cert_sk[i] = cert_new_exts(&certs[i]);
+		}
+	}
+
+	/*
+	 * Create the certificates. cert_new() takes the issuer identity from a
+	 * certificate created earlier, so the certificates are signed as soon as
+	 * their issuer certificate is available.
+	 */
+	if (!run_jobs(num_certs, sign_job, sign_ready)) {
+		exit(1);
+	}
+
+	for (i = 0 ; i < num_certs ; i++) {
+		if (cert_sk[i] == NULL) {
+			continue;
+		}
+
+		for (cert_ext = sk_X509_EXTENSION_pop(cert_sk[i]);
+				cert_ext != NULL;
+				cert_ext = sk_X509_EXTENSION_pop(cert_sk[i])) {
+			X509_EXTENSION_free(cert_ext);
+		}
+
+		sk_X509_EXTENSION_free(cert_sk[i]);
+		cert_sk[i] = NULL;
+	}
 
 	/* Print the certificates */
 	if (print_cert) {
@@ -596,8 +1061,141 @@ int main(int argc, char *argv[])
 	 */
 	for (i = 0; i < num_keys; i++) {
 		EVP_PKEY_free(keys[i].key);
+		keys[i].key = NULL;
+	}
+
+	for (i = 0; i < num_certs; i++) {
+		X509_free(certs[i].x);
+		certs[i].x = NULL;
+	}
+}
+
+/*
+ * Generate one CoT set per line of the batch file. Lines are split on white
+ * space, quoting is not supported.
+ */
+static void run_batch(const char *cmd, const struct option *cmd_opt)
+{
+	FILE *file;
+	char line[4096];
+	char *argv[2 * CMD_OPT_MAX_NUM + 2];
+	char *tok;
+	int argc, line_num = 0;
+
+	file = fopen(batch_fn, "r");
+	if (file == NULL) {
+		ERROR("Cannot open batch file %s\n", batch_fn);
+		exit(1);
+	}
+
+	save_cmd_line();
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		line_num++;
+
+		if (strchr(line, '\n') == NULL && !feof(file)) {
+			ERROR("%s:%d: line too long\n", batch_fn, line_num);
+			exit(1);
+		}
+
+		argc = 0;
+		argv[argc++] = (char *)cmd;
+		for (tok = strtok(line, " \t\r\n"); tok != NULL;
+		     tok = strtok(NULL, " \t\r\n")) {
+			if (argc == (int)NUM_ELEM(argv) - 1) {
+				ERROR("%s:%d: too many arguments\n", batch_fn,
+				      line_num);
+				exit(1);
+			}
+			argv[argc++] = tok;
+		}
+		argv[argc] = NULL;
+
+		if ((argc == 1) || (argv[1][0] == '#')) {
+			continue;
+		}
+
+		NOTICE("CoT set %u (%s:%d)\n", cot_set, batch_fn, line_num);
+
+		restore_cmd_line();
+		parse_opts(argc, argv, cmd, cmd_opt, 1);
+		generate_cot();
+		cot_set++;
 	}
 
+	fclose(file);
+}
+
+int main(int argc, char *argv[])
+{
+	const struct option *cmd_opt;
+	int i;
+
+	NOTICE("CoT Generation Tool: %s\n", build_msg);
+	NOTICE("Target platform: %s\n", platform_msg);
+
+	/* Set default options */
+	key_alg = KEY_ALG_RSA;
+	hash_alg = HASH_ALG_SHA256;
+	key_size = -1;
+	num_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	if (num_jobs <= 0) {
+		num_jobs = 1;
+	}
+
+	/* Add common command line options */
+	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
+		cmd_opt_add(&common_cmd_opt[i]);
+	}
+
+	/* Initialize the certificates */
+	if (cert_init() != 0) {
+		ERROR("Cannot initialize certificates\n");
+		exit(1);
+	}
+
+	/* Initialize the keys */
+	if (key_init() != 0) {
+		ERROR("Cannot initialize keys\n");
+		exit(1);
+	}
+
+	/* Initialize the new types and register OIDs for the extensions */
+	if (ext_init() != 0) {
+		ERROR("Cannot initialize extensions\n");
+		exit(1);
+	}
+
+	/* Get the command line options populated during the initialization */
+	cmd_opt = cmd_opt_get_array();
+
+	parse_opts(argc, argv, argv[0], cmd_opt, 0);
+
+	CHECK_NULL(cert_cache, calloc(num_certs, sizeof(cert_cache[0])));
+	CHECK_NULL(cert_uid, calloc(num_certs, sizeof(cert_uid[0])));
+	CHECK_NULL(cert_sk, calloc(num_certs, sizeof(cert_sk[0])));
+	CHECK_NULL(hash_fn, calloc(num_extensions, sizeof(hash_fn[0])));
+	CHECK_NULL(hash_md, calloc(num_extensions, sizeof(hash_md[0])));
+
+	if (batch_fn != NULL) {
+		run_batch(argv[0], cmd_opt);
+	} else {
+		generate_cot();
+	}
+
+	for (i = 0; i < num_certs; i++) {
+		free(cert_cache[i].inputs);
+		X509_free(cert_cache[i].x);
+	}
+	free(cert_cache);
+	free(cert_uid);
+	free(cert_sk);
+	free(hash_fn);
+	free(hash_md);
+
+	key_cache_free();
+	sha_cache_free();
+
 #ifndef OPENSSL_NO_ENGINE
 	ENGINE_cleanup();
 #endif
@@ -606,29 +1204,29 @@ int main(int argc, char *argv[])
 
 	/* We allocated strings through strdup, so now we have to free them */
 	for (i = 0; i < num_keys; i++) {
-		if (keys[i].fn != NULL) {
-			void *ptr = keys[i].fn;
-
-			keys[i].fn = NULL;
-			free(ptr);
-		}
+		set_str(&keys[i].fn, NULL);
 	}
 	for (i = 0; i < num_extensions; i++) {
-		if (extensions[i].arg != NULL) {
-			void *ptr = (void *)extensions[i].arg;
-
-			extensions[i].arg = NULL;
-			free(ptr);
-		}
+		set_str((char **)&extensions[i].arg, NULL);
 	}
 	for (i = 0; i < num_certs; i++) {
-		if (certs[i].fn != NULL) {
-			void *ptr = (void *)certs[i].fn;
-
-			certs[i].fn = NULL;
-			free(ptr);
+		set_str((char **)&certs[i].fn, NULL);
+	}
+	if (cmd_line.ext_arg != NULL) {
+		for (i = 0; i < num_keys; i++) {
+			set_str(&cmd_line.key_fn[i], NULL);
+		}
+		for (i = 0; i < num_extensions; i++) {
+			set_str(&cmd_line.ext_arg[i], NULL);
+		}
+		for (i = 0; i < num_certs; i++) {
+			set_str(&cmd_line.cert_fn[i], NULL);
 		}
+		free(cmd_line.key_fn);
+		free(cmd_line.ext_arg);
+		free(cmd_line.cert_fn);
 	}
+	set_str(&batch_fn, NULL);
 
 	return 0;
 }
@@ -6,10 +6,26 @@
 
 #include <openssl/sha.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "debug.h"
 #include "key.h"
+#include "sha.h"
 
-#define BUFFER_SIZE	256
+#define BUFFER_SIZE	16384
+
+/*
+ * Image hashes already computed by this invocation, looked up by file name.
+ * Images are not expected to change while the tool is running.
+ */
+typedef struct sha_cache_s {
+	char *fn;
+	int md_alg;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	struct sha_cache_s *next;
+} sha_cache_t;
+
+static sha_cache_t *sha_cache;
 
 int sha_file(int md_alg, const char *filename, unsigned char *md)
 {
@@ -53,3 +69,54 @@ int sha_file(int md_alg, const char *filename, unsigned char *md)
 	fclose(inFile);
 	return 1;
 }
+
+int sha_cache_get(int md_alg, const char *filename, unsigned char *md)
+{
+	sha_cache_t *entry;
+
+	for (entry = sha_cache; entry != NULL; entry = entry->next) {
+		if ((entry->md_alg == md_alg) &&
+		    (strcmp(entry->fn, filename) == 0)) {
+			memcpy(md, entry->md, SHA512_DIGEST_LENGTH);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int sha_cache_add(int md_alg, const char *filename, const unsigned char *md)
+{
+	sha_cache_t *entry;
+
+	entry = malloc(sizeof(*entry));
+	if (entry == NULL) {
+		return 0;
+	}
+
+	entry->fn = malloc(strlen(filename) + 1);
+	if (entry->fn == NULL) {
+		free(entry);
+		return 0;
+	}
+	strcpy(entry->fn, filename);
+
+	entry->md_alg = md_alg;
+	memcpy(entry->md, md, SHA512_DIGEST_LENGTH);
+	entry->next = sha_cache;
+	sha_cache = entry;
+
+	return 1;
+}
+
+void sha_cache_free(void)
+{
+	sha_cache_t *entry;
+
+	while (sha_cache != NULL) {
+		entry = sha_cache;
+		sha_cache = entry->next;
+		free(entry->fn);
+		free(entry);
+	}
+}
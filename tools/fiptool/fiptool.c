@@ -22,6 +22,10 @@
 #define OPT_TOC_ENTRY 0
 #define OPT_PLAT_TOC_FLAGS 1
 #define OPT_ALIGN 2
+#define OPT_IN_PLACE 3
+
+/* Number of buffers handed to the kernel in a single writev() call */
+#define WRITE_BATCH 64
 
 static int info_cmd(int argc, char *argv[]);
 static void info_usage(int);
@@ -53,6 +57,20 @@ static image_desc_t *image_desc_head;
 static size_t nr_image_descs;
 static const uuid_t uuid_null;
 static int verbose;
+static int jobs = 1;
+
+#ifndef _MSC_VER
+/* Files mapped by load_file(), released by unmap_files(). */
+typedef struct file_map {
+	void	*addr;
+	size_t	 size;
+	dev_t	 dev;
+	ino_t	 ino;
+} file_map_t;
+
+static file_map_t *file_maps;
+static size_t nr_file_maps;
+#endif
 
 static void vlog(int prio, const char *msg, va_list ap)
 {
@@ -170,7 +188,8 @@ static void free_image_desc(image_desc_t *desc)
 	free(desc->cmdline_name);
 	free(desc->action_arg);
 	if (desc->image) {
-		free(desc->image->buffer);
+		if (!desc->image->mapped)
+			free(desc->image->buffer);
 		free(desc->image);
 	}
 	free(desc);
@@ -290,6 +309,75 @@ static void uuid_from_str(uuid_t *u, const char *s)
 		log_errx("Invalid UUID: %s", s);
 }
 
+/*
+ * Get the contents of an open file. Where the platform allows it the file is
+ * mapped rather than read, so large images are neither copied nor loaded in
+ * memory before they are needed. The buffer is read-only and is only owned by
+ * the caller when '*mapped' is returned as 0.
+ */
+static void *load_file(FILE *fp, const char *filename,
+    const struct BLD_PLAT_STAT *st, int *mapped)
+{
+	void *buf;
+
+#ifndef _MSC_VER
+	if (st->st_size > 0) {
+		buf = mmap(NULL, st->st_size, PROT_READ, MAP_PRIVATE,
+		    fileno(fp), 0);
+		if (buf != MAP_FAILED) {
+			file_maps = realloc(file_maps,
+			    (nr_file_maps + 1) * sizeof(*file_maps));
+			if (file_maps == NULL)
+				log_err("realloc");
+			file_maps[nr_file_maps].addr = buf;
+			file_maps[nr_file_maps].size = st->st_size;
+			file_maps[nr_file_maps].dev = st->st_dev;
+			file_maps[nr_file_maps].ino = st->st_ino;
+			nr_file_maps++;
+			*mapped = 1;
+			return buf;
+		}
+		/* Not a regular file, read it instead. */
+	}
+#endif
+	*mapped = 0;
+	buf = xmalloc(st->st_size, "failed to load file into memory");
+	if (fread(buf, 1, st->st_size, fp) != st->st_size)
+		log_errx("Failed to read %s", filename);
+	return buf;
+}
+
+/* Check whether the images are backed by the given file. */
+static int is_file_mapped(const char *filename)
+{
+#ifndef _MSC_VER
+	struct BLD_PLAT_STAT st;
+	size_t i;
+
+	if (stat(filename, &st) == -1)
+		return 0;
+
+	for (i = 0; i < nr_file_maps; i++)
+		if (file_maps[i].dev == st.st_dev &&
+		    file_maps[i].ino == st.st_ino)
+			return 1;
+#endif
+	return 0;
+}
+
+static void unmap_files(void)
+{
+#ifndef _MSC_VER
+	size_t i;
+
+	for (i = 0; i < nr_file_maps; i++)
+		munmap(file_maps[i].addr, file_maps[i].size);
+	free(file_maps);
+	file_maps = NULL;
+	nr_file_maps = 0;
+#endif
+}
+
 static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 {
 	struct BLD_PLAT_STAT st;
@@ -298,6 +386,7 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	int terminated = 0;
+	int mapped;
 
 	fp = fopen(filename, "rb");
 	if (fp == NULL)
@@ -306,9 +395,7 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (fstat(fileno(fp), &st) == -1)
 		log_err("fstat %s", filename);
 
-	buf = xmalloc(st.st_size, "failed to load file into memory");
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
+	buf = load_file(fp, filename, &st, &mapped);
 	bufend = buf + st.st_size;
 	fclose(fp);
 
@@ -343,16 +430,22 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 		image = xzalloc(sizeof(*image),
 		    "failed to allocate memory for image");
 		image->toc_e = *toc_entry;
-		image->buffer = xmalloc(toc_entry->size,
-		    "failed to allocate image buffer, is FIP file corrupted?");
 		/* Overflow checks before memory copy. */
 		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
 			log_errx("FIP %s is corrupted", filename);
 		if (toc_entry->size + toc_entry->offset_address > st.st_size)
 			log_errx("FIP %s is corrupted", filename);
 
-		memcpy(image->buffer, buf + toc_entry->offset_address,
-		    toc_entry->size);
+		/* Images of a mapped FIP are used in place. */
+		if (mapped) {
+			image->buffer = buf + toc_entry->offset_address;
+			image->mapped = 1;
+		} else {
+			image->buffer = xmalloc(toc_entry->size,
+			    "failed to allocate image buffer, is FIP file corrupted?");
+			memcpy(image->buffer, buf + toc_entry->offset_address,
+			    toc_entry->size);
+		}
 
 		/* If this is an unknown image, create a descriptor for it. */
 		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
@@ -378,7 +471,8 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
+	if (!mapped)
+		free(buf);
 	return 0;
 }
 
@@ -400,9 +494,7 @@ static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 
 	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
 	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
+	image->buffer = load_file(fp, filename, &st, &image->mapped);
 	image->toc_e.size = st.st_size;
 
 	fclose(fp);
@@ -454,16 +546,60 @@ static void md_print(const unsigned char *md, size_t len)
 		printf("%02x", md[i]);
 }
 
-static int info_cmd(int argc, char *argv[])
+/*
+ * Run a command on each of the given FIP files. Every file is handled by a
+ * child process which inherits the parsed command line, so the image table
+ * never has to be reset, and up to 'jobs' of them run at the same time.
+ */
+static int for_each_fip(int argc, char *argv[],
+    int (*fn)(const char *, void *), void *arg)
+{
+#ifndef _MSC_VER
+	int i = 0, running = 0, status, ret = 0;
+	pid_t pid;
+
+	if (argc == 1)
+		return fn(argv[0], arg);
+
+	while (i < argc || running > 0) {
+		if (i < argc && running < jobs) {
+			/* Do not let the children flush our buffers again. */
+			fflush(NULL);
+			pid = fork();
+			if (pid == -1)
+				log_err("fork");
+			if (pid == 0)
+				exit(fn(argv[i], arg));
+			running++;
+			i++;
+			continue;
+		}
+
+		if (wait(&status) == -1)
+			log_err("wait");
+		running--;
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			ret = 1;
+	}
+
+	return ret;
+#else
+	if (argc > 1)
+		log_errx("Only one FIP file can be given on this platform");
+	return fn(argv[0], arg);
+#endif
+}
+
+static int info_fip(const char *filename, void *arg)
 {
 	image_desc_t *desc;
 	fip_toc_header_t toc_header;
+	int *multiple = arg;
 
-	if (argc != 2)
-		info_usage(EXIT_FAILURE);
-	argc--, argv++;
+	parse_fip(filename, &toc_header);
 
-	parse_fip(argv[0], &toc_header);
+	if (*multiple)
+		printf("%s:\n", filename);
 
 	if (verbose) {
 		log_dbgx("toc_header[name]: 0x%llX",
@@ -499,39 +635,238 @@ static int info_cmd(int argc, char *argv[])
 	return 0;
 }
 
+static int info_cmd(int argc, char *argv[])
+{
+	int multiple;
+
+	if (argc < 2)
+		info_usage(EXIT_FAILURE);
+	argc--, argv++;
+
+	multiple = argc > 1;
+	return for_each_fip(argc, argv, info_fip, &multiple);
+}
+
 static void info_usage(int exit_status)
 {
-	printf("fiptool info FIP_FILENAME\n");
+	printf("fiptool info FIP_FILENAME...\n");
 	exit(exit_status);
 }
 
-static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
+#ifndef _MSC_VER
+typedef struct fip_writer {
+	int		 fd;
+	const char	*filename;
+	struct iovec	 iov[WRITE_BATCH];
+	int		 nr_iov;
+	uint64_t	 offset;
+} fip_writer_t;
+
+static void writer_flush(fip_writer_t *w)
+{
+	struct iovec *iov = w->iov;
+	int nr_iov = w->nr_iov;
+	ssize_t n;
+
+	while (nr_iov > 0) {
+		n = writev(w->fd, iov, nr_iov);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			log_err("Failed to write %s", w->filename);
+		}
+
+		/* Skip what was written, the last buffer may be partial. */
+		while (nr_iov > 0 && (size_t)n >= iov->iov_len) {
+			n -= iov->iov_len;
+			iov++;
+			nr_iov--;
+		}
+		if (nr_iov > 0) {
+			iov->iov_base = (char *)iov->iov_base + n;
+			iov->iov_len -= n;
+		}
+	}
+	w->nr_iov = 0;
+}
+
+static void writer_add(fip_writer_t *w, const void *buf, size_t len)
+{
+	if (len == 0)
+		return;
+	if (w->nr_iov == WRITE_BATCH)
+		writer_flush(w);
+	w->iov[w->nr_iov].iov_base = (void *)buf;
+	w->iov[w->nr_iov].iov_len = len;
+	w->nr_iov++;
+	w->offset += len;
+}
+
+static void writer_pad(fip_writer_t *w, uint64_t offset)
+{
+	static const char zero[4096];
+	uint64_t len;
+
+	while (w->offset < offset) {
+		len = offset - w->offset;
+		if (len > sizeof(zero))
+			len = sizeof(zero);
+		writer_add(w, zero, len);
+	}
+}
+
+/*
+ * Copy the images backed by the given file into memory, so that the file can
+ * be truncated and rewritten in place.
+ */
+static void copy_mapped_images(const char *filename)
+{
+	struct BLD_PLAT_STAT st;
+	image_desc_t *desc;
+	size_t i;
+
+	if (stat(filename, &st) == -1)
+		log_err("stat %s", filename);
+
+	for (i = 0; i < nr_file_maps; i++) {
+		file_map_t *map = &file_maps[i];
+
+		if (map->dev != st.st_dev || map->ino != st.st_ino)
+			continue;
+
+		for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+			image_t *image = desc->image;
+			char *start = map->addr;
+			void *buf;
+
+			if (image == NULL || !image->mapped ||
+			    (char *)image->buffer < start ||
+			    (char *)image->buffer >= start + map->size)
+				continue;
+
+			buf = xmalloc(image->toc_e.size,
+			    "failed to allocate image buffer, is it too big?");
+			memcpy(buf, image->buffer, image->toc_e.size);
+			image->buffer = buf;
+			image->mapped = 0;
+		}
+	}
+}
+
+/*
+ * Write the FIP straight from the image buffers, which are mostly file
+ * mappings, with a few writev() calls. If the output is one of the mapped
+ * files, its images are copied first, as truncating it would pull them from
+ * under our feet. The file is always written in place, so that symlinks,
+ * hard links, ownership and ACLs are kept.
+ */
+static void write_fip(const char *filename, const void *toc, size_t toc_size,
+    uint64_t fip_size)
+{
+	fip_writer_t w = { .filename = filename };
+	image_desc_t *desc;
+
+	if (is_file_mapped(filename))
+		copy_mapped_images(filename);
+
+	w.fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (w.fd == -1)
+		log_err("open %s", filename);
+
+	writer_add(&w, toc, toc_size);
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL)
+			continue;
+		writer_pad(&w, image->toc_e.offset_address);
+		writer_add(&w, image->buffer, image->toc_e.size);
+	}
+
+	writer_pad(&w, fip_size);
+	writer_flush(&w);
+
+	if (close(w.fd) == -1)
+		log_err("close %s", filename);
+}
+#else
+static void write_fip(const char *filename, const void *toc, size_t toc_size,
+    uint64_t fip_size)
 {
 	FILE *fp;
+	image_desc_t *desc;
+	uint64_t entry_offset = toc_size, pad_size;
+
+	fp = fopen(filename, "wb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	xfwrite((void *)toc, toc_size, fp, filename);
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL)
+			continue;
+		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
+			log_errx("Failed to set file position");
+
+		xfwrite(image->buffer, image->toc_e.size, fp, filename);
+		entry_offset = image->toc_e.offset_address + image->toc_e.size;
+	}
+
+	if (fseek(fp, entry_offset, SEEK_SET))
+		log_errx("Failed to set file position");
+
+	pad_size = fip_size - entry_offset;
+	while (pad_size--)
+		fputc(0x0, fp);
+
+	fclose(fp);
+}
+#endif
+
+/*
+ * Allocate the ToC for the images in the image table and fill in its header.
+ * The entries, including the terminator, are left for the caller.
+ */
+static char *alloc_toc(uint64_t toc_flags, uint64_t *buf_size,
+    fip_toc_entry_t **first_entry)
+{
 	image_desc_t *desc;
 	fip_toc_header_t *toc_header;
-	fip_toc_entry_t *toc_entry;
 	char *buf;
-	uint64_t entry_offset, buf_size, payload_size = 0, pad_size;
 	size_t nr_images = 0;
 
 	for (desc = image_desc_head; desc != NULL; desc = desc->next)
 		if (desc->image != NULL)
 			nr_images++;
 
-	buf_size = sizeof(fip_toc_header_t) +
+	*buf_size = sizeof(fip_toc_header_t) +
 	    sizeof(fip_toc_entry_t) * (nr_images + 1);
-	buf = calloc(1, buf_size);
+	buf = calloc(1, *buf_size);
 	if (buf == NULL)
 		log_err("calloc");
 
-	/* Build up header and ToC entries from the image table. */
 	toc_header = (fip_toc_header_t *)buf;
 	toc_header->name = TOC_HEADER_NAME;
 	toc_header->serial_number = TOC_HEADER_SERIAL_NUMBER;
 	toc_header->flags = toc_flags;
 
-	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+	*first_entry = (fip_toc_entry_t *)(toc_header + 1);
+	return buf;
+}
+
+static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
+{
+	image_desc_t *desc;
+	fip_toc_entry_t *toc_entry;
+	char *buf;
+	uint64_t entry_offset, buf_size, payload_size = 0;
+
+	/* Build up header and ToC entries from the image table. */
+	buf = alloc_toc(toc_flags, &buf_size, &toc_entry);
 
 	entry_offset = buf_size;
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
@@ -554,39 +889,15 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	memset(toc_entry, 0, sizeof(*toc_entry));
 	toc_entry->offset_address = (entry_offset + align - 1) & ~(align - 1);
 
-	/* Generate the FIP file. */
-	fp = fopen(filename, "wb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (verbose)
+	if (verbose) {
 		log_dbgx("Metadata size: %zu bytes", buf_size);
-
-	xfwrite(buf, buf_size, fp, filename);
-
-	if (verbose)
 		log_dbgx("Payload size: %zu bytes", payload_size);
-
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		image_t *image = desc->image;
-
-		if (image == NULL)
-			continue;
-		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
-			log_errx("Failed to set file position");
-
-		xfwrite(image->buffer, image->toc_e.size, fp, filename);
 	}
 
-	if (fseek(fp, entry_offset, SEEK_SET))
-		log_errx("Failed to set file position");
-
-	pad_size = toc_entry->offset_address - entry_offset;
-	while (pad_size--)
-		fputc(0x0, fp);
+	/* Generate the FIP file. */
+	write_fip(filename, buf, buf_size, toc_entry->offset_address);
 
 	free(buf);
-	fclose(fp);
 	return 0;
 }
 
@@ -627,6 +938,140 @@ static void update_fip(void)
 	}
 }
 
+static uint64_t get_file_size(const char *filename)
+{
+	struct BLD_PLAT_STAT st;
+	FILE *fp;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	if (fstat(fileno(fp), &st) == -1)
+		log_err("fstat %s", filename);
+
+	fclose(fp);
+	return st.st_size;
+}
+
+/*
+ * Replace images of an existing FIP without moving any other image: each new
+ * image is written over the old one, which must leave enough room before the
+ * next image, and the ToC is rewritten. Images whose contents did not change
+ * are not written at all. If the new images do not fit in the current layout,
+ * -1 is returned and the image table is left as it was.
+ */
+static int update_fip_in_place(const char *filename, uint64_t toc_flags,
+    unsigned long align)
+{
+	static const char zero[4096];
+	image_desc_t *desc, *other;
+	fip_toc_entry_t *toc_entry;
+	char *buf;
+	uint64_t buf_size, fip_size, end;
+	FILE *fp;
+
+	fip_size = get_file_size(filename);
+
+	/* Check that the layout can be kept. */
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL) {
+			if (desc->action == DO_PACK)
+				return -1;
+			continue;
+		}
+
+		if (image->toc_e.offset_address & (align - 1))
+			return -1;
+
+		if (desc->action != DO_PACK)
+			continue;
+
+		end = fip_size;
+		for (other = image_desc_head; other != NULL;
+		     other = other->next) {
+			uint64_t offset;
+
+			if (other->image == NULL)
+				continue;
+			offset = other->image->toc_e.offset_address;
+			if (offset > image->toc_e.offset_address && offset < end)
+				end = offset;
+		}
+
+		if (get_file_size(desc->action_arg) >
+		    end - image->toc_e.offset_address)
+			return -1;
+	}
+
+	fp = fopen(filename, "r+b");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image;
+		uint64_t pad_size;
+
+		if (desc->action != DO_PACK)
+			continue;
+
+		image = read_image_from_file(&desc->uuid, desc->action_arg);
+		image->toc_e.offset_address = desc->image->toc_e.offset_address;
+
+		if (image->toc_e.size == desc->image->toc_e.size &&
+		    memcmp(image->buffer, desc->image->buffer,
+		    image->toc_e.size) == 0) {
+			if (verbose)
+				log_dbgx("%s is unchanged", desc->cmdline_name);
+		} else {
+			if (verbose)
+				log_dbgx("Replacing %s with %s in place",
+				    desc->cmdline_name, desc->action_arg);
+
+			if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
+				log_errx("Failed to set file position");
+			xfwrite(image->buffer, image->toc_e.size, fp,
+			    filename);
+
+			/* Clear what is left of the previous image. */
+			pad_size = 0;
+			if (desc->image->toc_e.size > image->toc_e.size)
+				pad_size = desc->image->toc_e.size -
+				    image->toc_e.size;
+			while (pad_size > 0) {
+				size_t len = pad_size < sizeof(zero) ?
+				    pad_size : sizeof(zero);
+
+				xfwrite((void *)zero, len, fp, filename);
+				pad_size -= len;
+			}
+		}
+
+		if (!desc->image->mapped)
+			free(desc->image->buffer);
+		free(desc->image);
+		desc->image = image;
+	}
+
+	/* The ToC keeps its size, so it is rewritten in place as well. */
+	buf = alloc_toc(toc_flags, &buf_size, &toc_entry);
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->image != NULL)
+			*toc_entry++ = desc->image->toc_e;
+	toc_entry->offset_address = fip_size;
+
+	if (fseek(fp, 0, SEEK_SET))
+		log_errx("Failed to set file position");
+	xfwrite(buf, buf_size, fp, filename);
+
+	free(buf);
+	if (fclose(fp))
+		log_err("fclose %s", filename);
+	return 0;
+}
+
 static void parse_plat_toc_flags(const char *arg, unsigned long long *toc_flags)
 {
 	unsigned long long flags;
@@ -774,15 +1219,52 @@ static void create_usage(int exit_status)
 	exit(exit_status);
 }
 
+typedef struct fip_args {
+	char			outfile[PATH_MAX];
+	unsigned long long	toc_flags;
+	unsigned long		align;
+	int			pflag;
+	int			fflag;
+	int			in_place;
+} fip_args_t;
+
+static int update_fip_file(const char *filename, void *arg)
+{
+	fip_args_t *args = arg;
+	char outfile[PATH_MAX];
+	fip_toc_header_t toc_header = { 0 };
+	unsigned long long toc_flags;
+	int exists;
+
+	snprintf(outfile, sizeof(outfile), "%s",
+	    args->outfile[0] != '\0' ? args->outfile : filename);
+
+	exists = access(filename, F_OK) == 0;
+	if (exists)
+		parse_fip(filename, &toc_header);
+
+	if (args->pflag)
+		toc_header.flags &= ~(0xffffULL << 32);
+	toc_flags = (toc_header.flags |= args->toc_flags);
+
+	if (args->in_place && exists) {
+		if (update_fip_in_place(filename, toc_flags, args->align) == 0)
+			return 0;
+		if (verbose)
+			log_dbgx("%s cannot be updated in place", filename);
+	}
+
+	update_fip();
+
+	pack_images(outfile, toc_flags, args->align);
+	return 0;
+}
+
 static int update_cmd(int argc, char *argv[])
 {
 	struct option *opts = NULL;
 	size_t nr_opts = 0;
-	char outfile[PATH_MAX] = { 0 };
-	fip_toc_header_t toc_header = { 0 };
-	unsigned long long toc_flags = 0;
-	unsigned long align = 1;
-	int pflag = 0;
+	fip_args_t args = { .align = 1 };
 
 	if (argc < 2)
 		update_usage(EXIT_FAILURE);
@@ -790,6 +1272,7 @@ static int update_cmd(int argc, char *argv[])
 	opts = fill_common_opts(opts, &nr_opts, required_argument);
 	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
 	opts = add_opt(opts, &nr_opts, "blob", required_argument, 'b');
+	opts = add_opt(opts, &nr_opts, "in-place", no_argument, OPT_IN_PLACE);
 	opts = add_opt(opts, &nr_opts, "out", required_argument, 'o');
 	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
@@ -811,8 +1294,8 @@ static int update_cmd(int argc, char *argv[])
 			break;
 		}
 		case OPT_PLAT_TOC_FLAGS:
-			parse_plat_toc_flags(optarg, &toc_flags);
-			pflag = 1;
+			parse_plat_toc_flags(optarg, &args.toc_flags);
+			args.pflag = 1;
 			break;
 		case 'b': {
 			char name[_UUID_STR_LEN + 1];
@@ -837,10 +1320,14 @@ static int update_cmd(int argc, char *argv[])
 			break;
 		}
 		case OPT_ALIGN:
-			align = get_image_align(optarg);
+			args.align = get_image_align(optarg);
+			break;
+		case OPT_IN_PLACE:
+			args.in_place = 1;
 			break;
 		case 'o':
-			snprintf(outfile, sizeof(outfile), "%s", optarg);
+			snprintf(args.outfile, sizeof(args.outfile), "%s",
+			    optarg);
 			break;
 		default:
 			update_usage(EXIT_FAILURE);
@@ -853,32 +1340,23 @@ static int update_cmd(int argc, char *argv[])
 	if (argc == 0)
 		update_usage(EXIT_SUCCESS);
 
-	if (outfile[0] == '\0')
-		snprintf(outfile, sizeof(outfile), "%s", argv[0]);
-
-	if (access(argv[0], F_OK) == 0)
-		parse_fip(argv[0], &toc_header);
-
-	if (pflag)
-		toc_header.flags &= ~(0xffffULL << 32);
-	toc_flags = (toc_header.flags |= toc_flags);
-
-	update_fip();
+	if (args.outfile[0] != '\0' && (argc > 1 || args.in_place))
+		update_usage(EXIT_FAILURE);
 
-	pack_images(outfile, toc_flags, align);
-	return 0;
+	return for_each_fip(argc, argv, update_fip_file, &args);
 }
 
 static void update_usage(int exit_status)
 {
 	toc_entry_t *toc_entry = toc_entries;
 
-	printf("fiptool update [opts] FIP_FILENAME\n");
+	printf("fiptool update [opts] FIP_FILENAME...\n");
 	printf("\n");
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
 	printf("  --blob uuid=...,file=...\tAdd or update an image with the given UUID pointed to by file.\n");
-	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
+	printf("  --in-place\t\t\tOnly rewrite the images that changed, if they fit in the current layout.\n");
+	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file (single FIP only).\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
 	printf("\n");
 	printf("Specific images are packed with the following options:\n");
@@ -1036,15 +1514,43 @@ static void unpack_usage(int exit_status)
 	exit(exit_status);
 }
 
+static int remove_fip_file(const char *filename, void *arg)
+{
+	fip_args_t *args = arg;
+	char outfile[PATH_MAX];
+	fip_toc_header_t toc_header;
+	image_desc_t *desc;
+
+	snprintf(outfile, sizeof(outfile), "%s",
+	    args->outfile[0] != '\0' ? args->outfile : filename);
+
+	parse_fip(filename, &toc_header);
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		if (desc->action != DO_REMOVE)
+			continue;
+
+		if (desc->image != NULL) {
+			if (verbose)
+				log_dbgx("Removing %s",
+				    desc->cmdline_name);
+			free(desc->image);
+			desc->image = NULL;
+		} else {
+			log_warnx("%s does not exist in %s",
+			    desc->cmdline_name, filename);
+		}
+	}
+
+	pack_images(outfile, toc_header.flags, args->align);
+	return 0;
+}
+
 static int remove_cmd(int argc, char *argv[])
 {
 	struct option *opts = NULL;
 	size_t nr_opts = 0;
-	char outfile[PATH_MAX] = { 0 };
-	fip_toc_header_t toc_header;
-	image_desc_t *desc;
-	unsigned long align = 1;
-	int fflag = 0;
+	fip_args_t args = { .align = 1 };
 
 	if (argc < 2)
 		remove_usage(EXIT_FAILURE);
@@ -1072,7 +1578,7 @@ static int remove_cmd(int argc, char *argv[])
 			break;
 		}
 		case OPT_ALIGN:
-			align = get_image_align(optarg);
+			args.align = get_image_align(optarg);
 			break;
 		case 'b': {
 			char name[_UUID_STR_LEN + 1], filename[PATH_MAX];
@@ -1095,10 +1601,11 @@ static int remove_cmd(int argc, char *argv[])
 			break;
 		}
 		case 'f':
-			fflag = 1;
+			args.fflag = 1;
 			break;
 		case 'o':
-			snprintf(outfile, sizeof(outfile), "%s", optarg);
+			snprintf(args.outfile, sizeof(args.outfile), "%s",
+			    optarg);
 			break;
 		default:
 			remove_usage(EXIT_FAILURE);
@@ -1111,46 +1618,28 @@ static int remove_cmd(int argc, char *argv[])
 	if (argc == 0)
 		remove_usage(EXIT_SUCCESS);
 
-	if (outfile[0] != '\0' && access(outfile, F_OK) == 0 && !fflag)
-		log_errx("File %s already exists, use --force to overwrite it",
-		    outfile);
-
-	if (outfile[0] == '\0')
-		snprintf(outfile, sizeof(outfile), "%s", argv[0]);
-
-	parse_fip(argv[0], &toc_header);
-
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		if (desc->action != DO_REMOVE)
-			continue;
+	if (args.outfile[0] != '\0' && argc > 1)
+		remove_usage(EXIT_FAILURE);
 
-		if (desc->image != NULL) {
-			if (verbose)
-				log_dbgx("Removing %s",
-				    desc->cmdline_name);
-			free(desc->image);
-			desc->image = NULL;
-		} else {
-			log_warnx("%s does not exist in %s",
-			    desc->cmdline_name, argv[0]);
-		}
-	}
+	if (args.outfile[0] != '\0' && access(args.outfile, F_OK) == 0 &&
+	    !args.fflag)
+		log_errx("File %s already exists, use --force to overwrite it",
+		    args.outfile);
 
-	pack_images(outfile, toc_header.flags, align);
-	return 0;
+	return for_each_fip(argc, argv, remove_fip_file, &args);
 }
 
 static void remove_usage(int exit_status)
 {
 	toc_entry_t *toc_entry = toc_entries;
 
-	printf("fiptool remove [opts] FIP_FILENAME\n");
+	printf("fiptool remove [opts] FIP_FILENAME...\n");
 	printf("\n");
 	printf("Options:\n");
 	printf("  --align <value>\tEach image is aligned to <value> (default: 1).\n");
 	printf("  --blob uuid=...\tRemove an image with the given UUID.\n");
 	printf("  --force\t\tIf the output FIP file already exists, use --force to overwrite it.\n");
-	printf("  --out FIP_FILENAME\tSet an alternative output FIP file.\n");
+	printf("  --out FIP_FILENAME\tSet an alternative output FIP file (single FIP only).\n");
 	printf("\n");
 	printf("Specific images are removed with the following options:\n");
 	for (; toc_entry->cmdline_name != NULL; toc_entry++)
@@ -1202,9 +1691,10 @@ static int help_cmd(int argc, char *argv[])
 
 static void usage(void)
 {
-	printf("usage: fiptool [--verbose] <command> [<args>]\n");
+	printf("usage: fiptool [--verbose] [--jobs N] <command> [<args>]\n");
 	printf("Global options supported:\n");
 	printf("  --verbose\tEnable verbose output for all commands.\n");
+	printf("  --jobs N\tProcess up to N FIP files at a time (info, update, remove).\n");
 	printf("\n");
 	printf("Commands supported:\n");
 	printf("  info\t\tList images contained in FIP.\n");
@@ -1225,6 +1715,7 @@ int main(int argc, char *argv[])
 		int c, opt_index = 0;
 		static struct option opts[] = {
 			{ "verbose", no_argument, NULL, 'v' },
+			{ "jobs", required_argument, NULL, 'j' },
 			{ NULL, no_argument, NULL, 0 }
 		};
 
@@ -1232,7 +1723,7 @@ int main(int argc, char *argv[])
 		 * Set POSIX mode so getopt stops at the first non-option
 		 * which is the subcommand.
 		 */
-		c = getopt_long(argc, argv, "+v", opts, &opt_index);
+		c = getopt_long(argc, argv, "+vj:", opts, &opt_index);
 		if (c == -1)
 			break;
 
@@ -1240,6 +1731,15 @@ int main(int argc, char *argv[])
 		case 'v':
 			verbose = 1;
 			break;
+		case 'j': {
+			char *endptr;
+
+			errno = 0;
+			jobs = strtol(optarg, &endptr, 10);
+			if (*endptr != '\0' || jobs < 1 || errno != 0)
+				log_errx("Invalid number of jobs: %s", optarg);
+			break;
+		}
 		default:
 			usage();
 		}
@@ -1262,5 +1762,6 @@ int main(int argc, char *argv[])
 	if (i == NELEM(cmds))
 		usage();
 	free_image_descs();
+	unmap_files();
 	return ret;
 }
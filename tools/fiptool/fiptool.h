@@ -43,6 +43,7 @@ typedef struct image_desc {
 typedef struct image {
 	struct fip_toc_entry toc_e;
 	void                *buffer;
+	int                  mapped;	/* buffer points into a file mapping */
 } image_t;
 
 typedef struct cmd {
@@ -15,8 +15,12 @@
 #ifndef _MSC_VER
 
 /* Not Visual Studio, so include Posix Headers. */
+# include <fcntl.h>
 # include <getopt.h>
 # include <openssl/sha.h>
+# include <sys/mman.h>
+# include <sys/uio.h>
+# include <sys/wait.h>
 # include <unistd.h>
 
 # define  BLD_PLAT_STAT stat
@@ -0,0 +1,450 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Extract the static board configuration of an S32 DTB into a C file, to be
+ * linked into BL2 and BL31 with S32_DT_STATIC_CONFIG=1. The layout of the
+ * output is described by plat/nxp/s32/include/s32_dt_config.h and the
+ * properties are read the way the firmware reads them.
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libfdt.h>
+
+#define FNV1A_BASIS		0x811c9dc5U
+#define FNV1A_PRIME		0x01000193U
+
+/* Keep in sync with s32_dt_config.h */
+#define MAX_CORES		8U
+#define MAX_I2C			8U
+
+#define IRQ_CELL_SIZE		3
+#define MAX_SPI_ID		1019U
+
+struct mem {
+	uint64_t base;
+	uint64_t size;
+};
+
+struct scp_irq {
+	uint32_t cpn;
+	uint32_t mscm_irq;
+	int irq_num;
+};
+
+static const char *dtb_name;
+
+static void warn(const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	fprintf(stderr, "s32_dt2c: %s: ", dtb_name);
+	vfprintf(stderr, fmt, ap);
+	fputc('\n', stderr);
+	va_end(ap);
+}
+
+static void *load_dtb(const char *path)
+{
+	FILE *f;
+	void *fdt;
+	long size;
+
+	f = fopen(path, "rb");
+	if (f == NULL) {
+		perror(path);
+		return NULL;
+	}
+
+	if ((fseek(f, 0, SEEK_END) != 0) || ((size = ftell(f)) <= 0) ||
+	    (fseek(f, 0, SEEK_SET) != 0)) {
+		perror(path);
+		fclose(f);
+		return NULL;
+	}
+
+	fdt = malloc((size_t)size);
+	if ((fdt == NULL) || (fread(fdt, 1, (size_t)size, f) != (size_t)size)) {
+		perror(path);
+		free(fdt);
+		fclose(f);
+		return NULL;
+	}
+
+	fclose(f);
+
+	if ((fdt_check_header(fdt) != 0) || (fdt_totalsize(fdt) > size)) {
+		warn("not a valid DTB");
+		free(fdt);
+		return NULL;
+	}
+
+	return fdt;
+}
+
+/* Must match dtb_hash() of plat/nxp/s32/s32_dt_config.c */
+static uint32_t dtb_hash(const void *fdt, size_t size)
+{
+	const uint8_t *bytes = fdt;
+	uint32_t hash = FNV1A_BASIS;
+	size_t i;
+
+	for (i = 0; i + 4 <= size; i += 4) {
+		hash ^= ((uint32_t)bytes[i] << 24) |
+			((uint32_t)bytes[i + 1] << 16) |
+			((uint32_t)bytes[i + 2] << 8) |
+			(uint32_t)bytes[i + 3];
+		hash *= FNV1A_PRIME;
+	}
+
+	for (; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= FNV1A_PRIME;
+	}
+
+	return hash;
+}
+
+static uint64_t read_cells(const fdt32_t *prop, int n)
+{
+	uint64_t val = 0;
+	int i;
+
+	for (i = 0; i < n; i++)
+		val = (val << 32) | fdt32_to_cpu(prop[i]);
+
+	return val;
+}
+
+/* Same as fdt_address_cells() and fdt_size_cells() */
+static int get_cells(const void *fdt, int node, const char *name, int dflt)
+{
+	const fdt32_t *prop;
+	int len;
+
+	prop = fdt_getprop(fdt, node, name, &len);
+	if (prop == NULL)
+		return dflt;
+
+	if ((len != (int)sizeof(*prop)) || (fdt32_to_cpu(*prop) > 4U))
+		return -FDT_ERR_BADNCELLS;
+
+	return (int)fdt32_to_cpu(*prop);
+}
+
+/* Same as fdt_get_reg_props_by_index(dtb, node, 0, ...) */
+static int get_reg(const void *fdt, int node, struct mem *mem)
+{
+	const fdt32_t *prop;
+	int parent, ac, sc, len;
+
+	parent = fdt_parent_offset(fdt, node);
+	if (parent < 0)
+		return parent;
+
+	ac = get_cells(fdt, parent, "#address-cells", 2);
+	sc = get_cells(fdt, parent, "#size-cells", 1);
+	if ((ac < 0) || (sc < 0))
+		return -FDT_ERR_BADNCELLS;
+
+	prop = fdt_getprop(fdt, node, "reg", &len);
+	if (prop == NULL)
+		return -FDT_ERR_NOTFOUND;
+
+	if ((ac + sc) * (int)sizeof(uint32_t) > len)
+		return -FDT_ERR_BADVALUE;
+
+	mem->base = read_cells(prop, ac);
+	mem->size = read_cells(&prop[ac], sc);
+
+	return 0;
+}
+
+/* Same as fdt_get_status() */
+static bool is_enabled(const void *fdt, int node)
+{
+	const char *status;
+	int len;
+
+	status = fdt_getprop(fdt, node, "status", &len);
+
+	return (status == NULL) || (strncmp(status, "okay", (size_t)len) == 0);
+}
+
+/* Same as fdt_read_irq_cells() */
+static int read_irq_cells(const fdt32_t *prop, int nr_cells)
+{
+	uint32_t res;
+
+	if (nr_cells < 2)
+		return -1;
+
+	res = fdt32_to_cpu(prop[1]);
+	if (res > MAX_SPI_ID)
+		return -1;
+
+	switch (fdt32_to_cpu(prop[0])) {
+	case 1:
+		return (int)res + 16;
+	case 0:
+		return (int)res + 32;
+	default:
+		return -1;
+	}
+}
+
+/* Same as scp_get_mb() */
+static int scp_get_mb(const void *fdt, int node, const char *name,
+		      struct mem *mb)
+{
+	const fdt32_t *phandles;
+	int idx, mb_node, len;
+
+	phandles = fdt_getprop(fdt, node, "nxp,scp-mboxes", &len);
+	if (phandles == NULL)
+		return -FDT_ERR_NOTFOUND;
+
+	idx = fdt_stringlist_search(fdt, node, "nxp,scp-mbox-names", name);
+	if ((idx < 0) || ((idx + 1) * (int)sizeof(uint32_t) > len))
+		return -FDT_ERR_NOTFOUND;
+
+	mb_node = fdt_node_offset_by_phandle(fdt, fdt32_to_cpu(phandles[idx]));
+	if (mb_node < 0)
+		return -FDT_ERR_NOTFOUND;
+
+	memset(mb, 0, sizeof(*mb));
+	if (!is_enabled(fdt, mb_node))
+		return 0;
+
+	return get_reg(fdt, mb_node, mb);
+}
+
+/* Same as scp_get_irq() */
+static int scp_get_irq(const void *fdt, int node, const char *name,
+		       struct scp_irq *irq)
+{
+	const fdt32_t *irqs, *cells;
+	int idx, irq_node, len;
+
+	irqs = fdt_getprop(fdt, node, "nxp,scp-irqs", &len);
+	if ((irqs == NULL) ||
+	    (len != IRQ_CELL_SIZE * 2 * (int)sizeof(uint32_t)))
+		return -FDT_ERR_BADVALUE;
+
+	idx = fdt_stringlist_search(fdt, node, "nxp,scp-irq-names", name);
+	if ((idx < 0) || (idx >= 2))
+		return -FDT_ERR_NOTFOUND;
+
+	irq_node = fdt_node_offset_by_phandle(fdt,
+			fdt32_to_cpu(irqs[IRQ_CELL_SIZE * idx]));
+	if (irq_node < 0)
+		return -FDT_ERR_NOTFOUND;
+
+	irq->cpn = fdt32_to_cpu(irqs[IRQ_CELL_SIZE * idx + 1]);
+	irq->mscm_irq = fdt32_to_cpu(irqs[IRQ_CELL_SIZE * idx + 2]);
+
+	cells = fdt_getprop(fdt, irq_node, "interrupts", &len);
+	if ((cells == NULL) ||
+	    ((uint64_t)(irq->mscm_irq + 1) * IRQ_CELL_SIZE * sizeof(uint32_t) >
+	     (uint64_t)len))
+		return -FDT_ERR_BADVALUE;
+
+	irq->irq_num = read_irq_cells(&cells[irq->mscm_irq * IRQ_CELL_SIZE],
+				      IRQ_CELL_SIZE);
+	if (irq->irq_num < 0)
+		return -FDT_ERR_BADVALUE;
+
+	return 0;
+}
+
+static void print_mem(FILE *out, const char *indent, const char *name,
+		      const struct mem *mem)
+{
+	fprintf(out, "%s", indent);
+	if (name != NULL)
+		fprintf(out, ".%s = ", name);
+	fprintf(out, "{ .base = 0x%llxUL, .size = 0x%llxUL },\n",
+		(unsigned long long)mem->base, (unsigned long long)mem->size);
+}
+
+static void print_irq(FILE *out, const char *name, const struct scp_irq *irq)
+{
+	fprintf(out, "\t\t.%s = { .cpn = %uU, .mscm_irq = %uU, .irq_num = %d },\n",
+		name, irq->cpn, irq->mscm_irq, irq->irq_num);
+}
+
+static unsigned int get_mbs(const void *fdt, int node, const char *prefix,
+			    struct mem *mbs)
+{
+	char name[32];
+	unsigned int n;
+
+	for (n = 0; n < MAX_CORES; n++) {
+		snprintf(name, sizeof(name), "%s%u", prefix, n);
+		if (scp_get_mb(fdt, node, name, &mbs[n]) != 0)
+			break;
+	}
+
+	return n;
+}
+
+/* Mirrors scp_scmi_dt_init(), each part is only emitted if it is complete */
+static void emit_scp(FILE *out, const void *fdt)
+{
+	struct mem tx_mbs[MAX_CORES], tx_mds[MAX_CORES];
+	struct mem rx_mb, rx_md, ospm_notif_mem;
+	struct scp_irq tx_irq, rx_irq;
+	unsigned int n_tx_mbs, n_tx_mds, i;
+	const fdt32_t *notif_irq;
+	int node, len, ospm_notif_irq = -1;
+	bool tx, rx, rx_md_ok;
+
+	node = fdt_node_offset_by_compatible(fdt, -1, "arm,scmi-smc");
+	if (node < 0) {
+		fprintf(out, "\t.scp = { .found = 0U },\n");
+		return;
+	}
+
+	n_tx_mbs = get_mbs(fdt, node, "scp_tx_mb", tx_mbs);
+	n_tx_mds = get_mbs(fdt, node, "scp_tx_md", tx_mds);
+	tx = (n_tx_mbs != 0U) && (scp_get_irq(fdt, node, "scp_tx", &tx_irq) == 0);
+
+	notif_irq = fdt_getprop(fdt, node, "nxp,notif-irq", &len);
+	if ((notif_irq != NULL) &&
+	    (len == IRQ_CELL_SIZE * (int)sizeof(uint32_t)))
+		ospm_notif_irq = read_irq_cells(notif_irq, IRQ_CELL_SIZE);
+
+	rx = (scp_get_mb(fdt, node, "scp_rx_mb", &rx_mb) == 0) &&
+	     (scp_get_mb(fdt, node, "scmi_ospm_notif", &ospm_notif_mem) == 0) &&
+	     (scp_get_irq(fdt, node, "scp_rx", &rx_irq) == 0) &&
+	     (ospm_notif_irq >= 0);
+	rx_md_ok = (scp_get_mb(fdt, node, "scp_rx_md", &rx_md) == 0);
+
+	if (!tx)
+		warn("incomplete SCP TX configuration, parsed at runtime");
+
+	fprintf(out, "\t.scp = {\n\t\t.found = %s%s%s%s0U,\n",
+		tx ? "S32_DT_SCP_TX | " : "",
+		(n_tx_mds != 0U) ? "S32_DT_SCP_TX_MD | " : "",
+		rx ? "S32_DT_SCP_RX | " : "",
+		rx_md_ok ? "S32_DT_SCP_RX_MD | " : "");
+
+	fprintf(out, "\t\t.n_tx_mbs = %uU,\n", tx ? n_tx_mbs : 0U);
+	fprintf(out, "\t\t.n_tx_mds = %uU,\n", n_tx_mds);
+
+	if (tx) {
+		fprintf(out, "\t\t.tx_mbs = {\n");
+		for (i = 0; i < n_tx_mbs; i++)
+			print_mem(out, "\t\t\t", NULL, &tx_mbs[i]);
+		fprintf(out, "\t\t},\n");
+		print_irq(out, "tx_irq", &tx_irq);
+	}
+
+	if (n_tx_mds != 0U) {
+		fprintf(out, "\t\t.tx_mds = {\n");
+		for (i = 0; i < n_tx_mds; i++)
+			print_mem(out, "\t\t\t", NULL, &tx_mds[i]);
+		fprintf(out, "\t\t},\n");
+	}
+
+	if (rx) {
+		print_mem(out, "\t\t", "rx_mb", &rx_mb);
+		print_irq(out, "rx_irq", &rx_irq);
+		print_mem(out, "\t\t", "ospm_notif_mem", &ospm_notif_mem);
+		fprintf(out, "\t\t.ospm_notif_irq = %d,\n", ospm_notif_irq);
+	}
+
+	if (rx_md_ok)
+		print_mem(out, "\t\t", "rx_md", &rx_md);
+
+	fprintf(out, "\t},\n");
+}
+
+/* Mirrors s32_i2c_get_setup_from_fdt() */
+static void emit_i2c(FILE *out, const void *fdt)
+{
+	const fdt32_t *speed;
+	unsigned int n = 0;
+	struct mem reg;
+	int node;
+
+	fprintf(out, "\t.i2c = {\n");
+
+	for (node = fdt_node_offset_by_compatible(fdt, -1, "nxp,s32cc-i2c");
+	     node >= 0;
+	     node = fdt_node_offset_by_compatible(fdt, node, "nxp,s32cc-i2c")) {
+		if (n == MAX_I2C) {
+			warn("too many I2C nodes, the others are parsed at runtime");
+			break;
+		}
+
+		if (get_reg(fdt, node, &reg) != 0)
+			continue;
+
+		speed = fdt_getprop(fdt, node, "clock-frequency", NULL);
+		fprintf(out, "\t\t{ .node = %d, .base = 0x%llxUL, ", node,
+			(unsigned long long)reg.base);
+		if (speed == NULL)
+			fprintf(out, ".speed = S32_DEFAULT_SPEED },\n");
+		else
+			fprintf(out, ".speed = %d },\n",
+				(int)fdt32_to_cpu(*speed));
+		n++;
+	}
+
+	fprintf(out, "\t},\n");
+	fprintf(out, "\t.n_i2c = %uU,\n", n);
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *out;
+	void *fdt;
+
+	if (argc != 3) {
+		fprintf(stderr, "usage: %s <dtb> <output.c>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	dtb_name = argv[1];
+	fdt = load_dtb(argv[1]);
+	if (fdt == NULL)
+		return EXIT_FAILURE;
+
+	out = fopen(argv[2], "w");
+	if (out == NULL) {
+		perror(argv[2]);
+		free(fdt);
+		return EXIT_FAILURE;
+	}
+
+	fprintf(out, "/* Generated by s32_dt2c from %s, do not edit */\n\n",
+		argv[1]);
+	fprintf(out, "#include <i2c/s32_i2c.h>\n");
+	fprintf(out, "#include <s32_dt_config.h>\n\n");
+	fprintf(out, "const struct s32_dt_config s32_dt_static_config = {\n");
+	fprintf(out, "\t.dtb_size = 0x%xU,\n", fdt_totalsize(fdt));
+	fprintf(out, "\t.dtb_hash = 0x%08xU,\n",
+		dtb_hash(fdt, fdt_totalsize(fdt)));
+	emit_scp(out, fdt);
+	emit_i2c(out, fdt);
+	fprintf(out, "};\n");
+
+	free(fdt);
+
+	if (fclose(out) != 0) {
+		perror(argv[2]);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,407 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Decode the binary trace of BL31 (S32_BL31_TRACE=1), from a dump of the
+ * 'tf-a-trace' reserved memory region and the ELF of the BL31 which wrote it.
+ * The format strings, and the strings passed to %s, are read from the ELF at
+ * the addresses stored in the trace. The entries of all cores are printed in
+ * the order of their timestamps.
+ *
+ * The layout of the dump is described by plat/nxp/s32/include/s32_trace.h.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Keep in sync with s32_trace.h */
+#define TRACE_MAGIC		0x43525453U
+#define TRACE_VERSION		1U
+#define TRACE_MAX_ARGS		4U
+#define TRACE_HEADER_SIZE	64U
+#define TRACE_CORE_SIZE		64U
+#define TRACE_ENTRY_SIZE	56U
+
+#define ELF_SHF_ALLOC		0x2U
+#define ELF_SHT_NOBITS		8U
+
+struct entry {
+	uint64_t time;
+	uint64_t fmt;
+	unsigned int core;
+	unsigned int nargs;
+	uint64_t args[TRACE_MAX_ARGS];
+	size_t order;
+};
+
+struct section {
+	uint64_t addr;
+	uint64_t size;
+	const uint8_t *data;
+};
+
+static struct section *sections;
+static size_t n_sections;
+
+static uint16_t get16(const uint8_t *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+	return (uint32_t)get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+static uint64_t get64(const uint8_t *p)
+{
+	return (uint64_t)get32(p) | ((uint64_t)get32(p + 4) << 32);
+}
+
+static uint8_t *load_file(const char *path, size_t *size)
+{
+	uint8_t *buf;
+	FILE *f;
+	long len;
+
+	f = fopen(path, "rb");
+	if (f == NULL) {
+		perror(path);
+		return NULL;
+	}
+
+	if ((fseek(f, 0, SEEK_END) != 0) || ((len = ftell(f)) <= 0) ||
+	    (fseek(f, 0, SEEK_SET) != 0)) {
+		perror(path);
+		fclose(f);
+		return NULL;
+	}
+
+	buf = malloc((size_t)len);
+	if ((buf == NULL) || (fread(buf, 1, (size_t)len, f) != (size_t)len)) {
+		perror(path);
+		free(buf);
+		fclose(f);
+		return NULL;
+	}
+
+	fclose(f);
+	*size = (size_t)len;
+
+	return buf;
+}
+
+/* The allocated sections of a little-endian ELF64, e.g. bl31.elf */
+static int load_sections(const uint8_t *elf, size_t size)
+{
+	uint64_t shoff, offset, sh_size;
+	uint16_t shentsize, shnum;
+	const uint8_t *sh;
+	unsigned int i;
+
+	if ((size < 64U) || (memcmp(elf, "\177ELF", 4) != 0) ||
+	    (elf[4] != 2U) || (elf[5] != 1U)) {
+		fprintf(stderr, "s32_trace: not a little-endian ELF64\n");
+		return -1;
+	}
+
+	shoff = get64(elf + 0x28);
+	shentsize = get16(elf + 0x3a);
+	shnum = get16(elf + 0x3c);
+	if ((shentsize < 64U) || (shoff > size) ||
+	    (((uint64_t)shnum * shentsize) > (size - shoff))) {
+		fprintf(stderr, "s32_trace: invalid section headers\n");
+		return -1;
+	}
+
+	sections = calloc(shnum, sizeof(*sections));
+	if (sections == NULL) {
+		perror("s32_trace");
+		return -1;
+	}
+
+	for (i = 0; i < shnum; i++) {
+		sh = elf + shoff + ((size_t)i * shentsize);
+		offset = get64(sh + 0x18);
+		sh_size = get64(sh + 0x20);
+
+		if (((get64(sh + 0x08) & ELF_SHF_ALLOC) == 0U) ||
+		    (get32(sh + 0x04) == ELF_SHT_NOBITS) ||
+		    (offset > size) || (sh_size > (size - offset)))
+			continue;
+
+		sections[n_sections].addr = get64(sh + 0x10);
+		sections[n_sections].size = sh_size;
+		sections[n_sections].data = elf + offset;
+		n_sections++;
+	}
+
+	return 0;
+}
+
+/* The string at 'addr' in BL31, or NULL */
+static const char *elf_string(uint64_t addr)
+{
+	const struct section *s;
+	size_t i;
+
+	for (i = 0; i < n_sections; i++) {
+		s = &sections[i];
+		if ((addr < s->addr) || ((addr - s->addr) >= s->size))
+			continue;
+
+		if (memchr(s->data + (addr - s->addr), '\0',
+			   s->size - (addr - s->addr)) == NULL)
+			return NULL;
+
+		return (const char *)(s->data + (addr - s->addr));
+	}
+
+	return NULL;
+}
+
+static uint64_t truncate_arg(uint64_t arg, unsigned int bits, bool is_signed)
+{
+	uint64_t mask;
+
+	if (bits >= 64U)
+		return arg;
+
+	mask = (UINT64_C(1) << bits) - 1U;
+	arg &= mask;
+	if (is_signed && ((arg >> (bits - 1U)) != 0U))
+		arg |= ~mask;
+
+	return arg;
+}
+
+/* printf() of the entry, with its arguments converted back to their types */
+static void print_entry(const struct entry *e, const char *fmt)
+{
+	char spec[32];
+	const char *p, *str;
+	unsigned int argi = 0, bits;
+	size_t len;
+	uint64_t arg;
+
+	for (p = fmt; *p != '\0'; p++) {
+		if (*p != '%') {
+			putchar(*p);
+			continue;
+		}
+
+		if (p[1] == '%') {
+			putchar('%');
+			p++;
+			continue;
+		}
+
+		/* Flags, width and precision are kept */
+		len = strspn(p + 1, "-+ #0123456789.") + 1U;
+		if (len > (sizeof(spec) - 4U))
+			len = sizeof(spec) - 4U;
+		memcpy(spec, p, len);
+		p += len;
+
+		/* Length modifiers are replaced by "ll" */
+		bits = 32U;
+		if ((p[0] == 'h') && (p[1] == 'h')) {
+			bits = 8U;
+			p += 2;
+		} else if (p[0] == 'h') {
+			bits = 16U;
+			p++;
+		} else if ((p[0] == 'l') && (p[1] == 'l')) {
+			bits = 64U;
+			p += 2;
+		} else if (strchr("lzjt", p[0]) != NULL) {
+			bits = 64U;
+			p++;
+		}
+
+		if (*p == '\0')
+			break;
+
+		if (argi >= e->nargs) {
+			printf("<missing>");
+			continue;
+		}
+		arg = e->args[argi++];
+
+		switch (*p) {
+		case 'd':
+		case 'i':
+			strcpy(spec + len, "lld");
+			printf(spec, (long long)truncate_arg(arg, bits, true));
+			break;
+		case 'u':
+		case 'x':
+		case 'X':
+		case 'o':
+			spec[len] = 'l';
+			spec[len + 1U] = 'l';
+			spec[len + 2U] = *p;
+			spec[len + 3U] = '\0';
+			printf(spec, (unsigned long long)
+			       truncate_arg(arg, bits, false));
+			break;
+		case 'c':
+			strcpy(spec + len, "c");
+			printf(spec, (int)(arg & 0xffU));
+			break;
+		case 'p':
+			printf("0x%" PRIx64, arg);
+			break;
+		case 's':
+			str = elf_string(arg);
+			if (str != NULL) {
+				strcpy(spec + len, "s");
+				printf(spec, str);
+			} else {
+				printf("<0x%" PRIx64 ">", arg);
+			}
+			break;
+		default:
+			printf("<%%%c 0x%" PRIx64 ">", *p, arg);
+			break;
+		}
+	}
+}
+
+static int cmp_entries(const void *a, const void *b)
+{
+	const struct entry *ea = a, *eb = b;
+
+	if (ea->time != eb->time)
+		return (ea->time < eb->time) ? -1 : 1;
+
+	return (ea->order < eb->order) ? -1 : (ea->order > eb->order);
+}
+
+static struct entry *load_entries(const uint8_t *trace, size_t size,
+				  size_t *n, uint64_t *freq)
+{
+	uint32_t n_cores, n_entries, core_size, entry_size;
+	uint64_t head, count, k;
+	const uint8_t *core, *raw;
+	struct entry *entries;
+	unsigned int c, i;
+
+	if ((size < TRACE_HEADER_SIZE) || (get32(trace) != TRACE_MAGIC) ||
+	    (get32(trace + 4) != TRACE_VERSION)) {
+		fprintf(stderr, "s32_trace: not a trace of version %u\n",
+			TRACE_VERSION);
+		return NULL;
+	}
+
+	n_cores = get32(trace + 8);
+	n_entries = get32(trace + 12);
+	core_size = get32(trace + 16);
+	entry_size = get32(trace + 20);
+	*freq = get64(trace + 24);
+
+	if ((entry_size != TRACE_ENTRY_SIZE) || (n_entries == 0U) ||
+	    (core_size < (TRACE_CORE_SIZE +
+			  ((uint64_t)n_entries * entry_size))) ||
+	    ((TRACE_HEADER_SIZE + ((uint64_t)n_cores * core_size)) > size)) {
+		fprintf(stderr, "s32_trace: truncated or invalid trace\n");
+		return NULL;
+	}
+
+	entries = calloc((size_t)n_cores * n_entries, sizeof(*entries));
+	if (entries == NULL) {
+		perror("s32_trace");
+		return NULL;
+	}
+
+	*n = 0;
+	for (c = 0; c < n_cores; c++) {
+		core = trace + TRACE_HEADER_SIZE + ((size_t)c * core_size);
+		head = get64(core);
+		count = (head < n_entries) ? head : n_entries;
+
+		for (k = head - count; k < head; k++) {
+			raw = core + TRACE_CORE_SIZE +
+			      ((k % n_entries) * entry_size);
+
+			entries[*n].time = get64(raw);
+			entries[*n].fmt = get64(raw + 8);
+			entries[*n].core = get16(raw + 16);
+			entries[*n].nargs = get16(raw + 18);
+			if (entries[*n].nargs > TRACE_MAX_ARGS)
+				entries[*n].nargs = TRACE_MAX_ARGS;
+			for (i = 0; i < TRACE_MAX_ARGS; i++)
+				entries[*n].args[i] = get64(raw + 24 + (i * 8));
+			entries[*n].order = *n;
+			(*n)++;
+		}
+	}
+
+	qsort(entries, *n, sizeof(*entries), cmp_entries);
+
+	return entries;
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t *elf, *trace;
+	size_t elf_size, trace_size, n, i;
+	struct entry *entries;
+	const char *fmt;
+	uint64_t freq;
+	int ret = EXIT_FAILURE;
+
+	if (argc != 3) {
+		fprintf(stderr, "usage: %s <bl31.elf> <trace dump>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	elf = load_file(argv[1], &elf_size);
+	if (elf == NULL)
+		return EXIT_FAILURE;
+
+	trace = load_file(argv[2], &trace_size);
+	if (trace == NULL)
+		goto free_elf;
+
+	if (load_sections(elf, elf_size) != 0)
+		goto free_trace;
+
+	entries = load_entries(trace, trace_size, &n, &freq);
+	if (entries == NULL)
+		goto free_trace;
+
+	for (i = 0; i < n; i++) {
+		if (freq != 0U)
+			printf("[%12.6f] ", (double)entries[i].time / freq);
+		else
+			printf("[%12" PRIu64 "] ", entries[i].time);
+		printf("core %u: ", entries[i].core);
+
+		fmt = elf_string(entries[i].fmt);
+		if (fmt == NULL) {
+			printf("<format at 0x%" PRIx64 " not in the ELF>\n",
+			       entries[i].fmt);
+			continue;
+		}
+
+		print_entry(&entries[i], fmt);
+		if ((fmt[0] == '\0') || (fmt[strlen(fmt) - 1U] != '\n'))
+			putchar('\n');
+	}
+
+	ret = EXIT_SUCCESS;
+	free(entries);
+free_trace:
+	free(trace);
+free_elf:
+	free(elf);
+	free(sections);
+
+	return ret;
+}